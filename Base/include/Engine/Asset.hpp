@@ -27,10 +27,12 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #pragma once
+#include <atomic>
 #include <Framework/Memory/Object.hpp>
 #include <Framework/String.hpp>
 #include <Framework/Name.hpp>
 #include <Framework/TypeInfo.hpp>
+#include "Engine/AssetType.hpp"
 
 namespace bp3d
 {
@@ -38,21 +40,27 @@ namespace bp3d
     {
     private:
         bpf::Name _type;
+        bpf::uint32 _typeId;
         bpf::Name _vPathHash;
         bpf::String _vPathStr;
+        std::atomic<bpf::fsize> _useCount; //Pinned from any thread through AssetManager::Get(guard, handle)
 
     public:
         inline Asset(const bpf::Name &type, const bpf::String &vpath)
             : _type(type)
+            , _typeId(AssetType::Register(type))
             , _vPathHash(bpf::Name(vpath))
             , _vPathStr(vpath)
+            , _useCount(0)
         {
         }
 
         inline Asset()
             : _type("bp3d::Asset")
+            , _typeId(AssetType::Register(_type))
             , _vPathHash("Invalid")
             , _vPathStr("Invalid")
+            , _useCount(0)
         {
         }
 
@@ -70,6 +78,49 @@ namespace bp3d
         {
             return (_type);
         }
+
+        /**
+         * Returns the dense identifier of the type of this asset, see AssetType
+         */
+        inline bpf::uint32 TypeId() const noexcept
+        {
+            return (_typeId);
+        }
+
+        /**
+         * Returns the number of bytes of main memory held by this asset
+         */
+        virtual bpf::fsize GetCPUSize() const noexcept
+        {
+            return (0);
+        }
+
+        /**
+         * Returns the number of bytes of video memory held by this asset
+         */
+        virtual bpf::fsize GetGPUSize() const noexcept
+        {
+            return (0);
+        }
+
+        /**
+         * Marks this asset as in use, an asset in use is never evicted by the AssetManager
+         * Thread safe, an asset resolved on another thread may be evicted by a Poll running before AddUse
+         */
+        inline void AddUse() noexcept
+        {
+            _useCount.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline void RemoveUse() noexcept
+        {
+            _useCount.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        inline bpf::fsize GetUseCount() const noexcept
+        {
+            return (_useCount.load(std::memory_order_relaxed));
+        }
     };
 }
 
@@ -0,0 +1,95 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <Framework/String.hpp>
+#include <Framework/IO/File.hpp>
+#include <Framework/System/Paths.hpp>
+#include "Engine/IAssetBuilder.hpp"
+
+namespace bp3d
+{
+    /**
+     * On-disk cache of built assets, stored in the Assets folder of the application's cache directory
+     * Each blob is keyed by the asset format (which selects the provider), the hash of the source file content and the builder cache version
+     * Only builders returning a non-zero cache version are cached, see IAssetBuilder::GetCacheVersion
+     * Load and Store are called concurrently by the build workers, this class holds no mutable state
+     */
+    class BP3D_API AssetBuildCache
+    {
+    private:
+        bpf::system::Paths _paths;
+        bpf::io::File _directory;
+
+    public:
+        /**
+         * Constructs a new AssetBuildCache
+         * @param paths the application paths used to expand asset locations and to locate the cache directory
+         */
+        explicit AssetBuildCache(const bpf::system::Paths &paths);
+
+        /**
+         * Creates the cache directory if needed
+         * @return false if the cache directory could not be created
+         */
+        bool Initialize();
+
+        inline const bpf::system::Paths &GetPaths() const noexcept
+        {
+            return (_paths);
+        }
+
+        /**
+         * Computes the hash of the content of a file
+         * @return false if the file could not be read
+         */
+        static bool HashFile(const bpf::io::File &file, bpf::uint64 &hash);
+
+        /**
+         * Returns the location of the blob matching the given key
+         */
+        bpf::io::File GetBlobPath(const bpf::String &format, bpf::uint64 sourceHash, bpf::uint32 version) const;
+
+        /**
+         * Looks up the blob of a builder and restores the builder from it
+         * @param format the asset format the builder was created for
+         * @param source the source file of the asset
+         * @param builder the builder to restore
+         * @param blob output location of the blob, to be passed to Store on a miss, empty if the source could not be read
+         * @return true if the builder was restored and no longer needs to be built
+         */
+        bool Load(const bpf::String &format, const bpf::io::File &source, IAssetBuilder &builder, bpf::io::File &blob) const;
+
+        /**
+         * Serializes a freshly built builder into its blob, failures are ignored as the cache is only an optimization
+         * @param builder the builder to serialize
+         * @param blob the location obtained from Load
+         */
+        void Store(const IAssetBuilder &builder, const bpf::io::File &blob) const;
+    };
+}
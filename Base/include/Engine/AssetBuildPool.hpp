@@ -0,0 +1,258 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <atomic>
+#include <Framework/System/Mutex.hpp>
+#include <Framework/System/ConditionVariable.hpp>
+#include <Framework/Collection/Queue.hpp>
+#include <Framework/Collection/ArrayList.hpp>
+#include <Framework/Collection/HashMap.hpp>
+#include "Engine/IAssetBuilder.hpp"
+#include "Engine/AssetBuildThread.hpp"
+#include "Engine/EAssetPriority.hpp"
+#include "Engine/RingQueue.hpp"
+#include "Engine/CancellationToken.hpp"
+#include "Engine/AssetBuildCache.hpp"
+#include "Engine/AssetLoadStats.hpp"
+#include "Engine/AssetTracer.hpp"
+
+namespace bp3d
+{
+    /**
+     * Pool of asset build workers
+     * Entries are built in parallel by the workers and are made available to the main thread through PollMountableEntry
+     * Workers are started once by the constructor and sleep until new entries are queued
+     * Entries travel through lock-free queues: the mutex is only taken to put a thread to sleep or to wake it up
+     * There is one pending and one mountable queue per priority, workers and PollMountableEntry always serve the highest priority first
+     * Workers are split in an IO group and a compute group, each with its own pending queues:
+     * staged builders are read by the IO workers then handed over to the compute workers, other builders only go through the compute workers
+     * Cancelled entries are skipped by the workers if not yet started and dropped by PollMountableEntry otherwise
+     * Refinements of mounted assets always go to the compute workers and bypass the build cache
+     */
+    class BP3D_API AssetBuildPool
+    {
+    public:
+        struct Entry
+        {
+            bpf::String VPath;
+            bpf::memory::UniquePtr<IAssetBuilder> Builder;
+            bpf::String Error;
+            EAssetPriority Priority;
+            bpf::String Format; //Asset format, only used by the build cache
+            bpf::io::File Source; //Source file of a cacheable builder, empty if the entry is not cached
+            bpf::io::File CacheBlob; //Set by the workers when looking up the build cache
+            AssetTimings Timings; //Queue wait and build times, filled by the workers
+            bpf::uint64 ReadyMicros = 0; //When the entry last became ready for its next step, see AssetTimings::Now
+            bpf::uint32 RefineSerial = 0; //Non zero when the builder refines an already mounted asset, see IAssetBuilder::HasRefinement
+            bpf::uint32 SlotIndex = 0; //Handle of the slot the entry was queued for, a slot released meanwhile drops the entry
+            bpf::uint32 SlotGeneration = 0;
+        };
+
+    private:
+        /**
+         * A queued entry shared between the queues
+         * Changing the priority of a queued job pushes another reference to it in the queue of the new priority,
+         * the first reference to be popped claims the job and the others are dropped
+         */
+        struct Job : public Entry
+        {
+            std::atomic<int> State; //Stage whose queue the job waits in, or JOB_CLAIMED
+            std::atomic<int> CurPriority;
+            std::atomic<bpf::fsize> Refs;
+            CancellationToken Token;
+            bpf::collection::ArrayList<bpf::io::ByteBuf> Buffers; //Output of the IO stage
+        };
+
+        using JobQueue = RingQueue<Job *>;
+
+        bpf::memory::UniquePtr<JobQueue> _pendingJobs[BUILD_STAGE_COUNT][ASSET_PRIORITY_COUNT];
+        bpf::memory::UniquePtr<JobQueue> _mountableJobs[ASSET_PRIORITY_COUNT];
+        bpf::collection::Queue<Job *> _overflow[BUILD_STAGE_COUNT][ASSET_PRIORITY_COUNT]; //Main thread only: jobs which did not fit in _pendingJobs
+        bpf::collection::HashMap<bpf::Name, Job *> _queuedJobs; //Main thread only: jobs which can still be re-prioritized
+        bpf::system::Mutex _mutex;
+        bpf::system::ConditionVariable _pendingCond[BUILD_STAGE_COUNT];
+        bpf::system::ConditionVariable _mountableCond;
+        std::atomic<bpf::fsize> _building; //Number of entries either pending or currently being built, in any stage
+        std::atomic<bpf::fsize> _sleepingWorkers[BUILD_STAGE_COUNT];
+        std::atomic<bool> _mainWaiting;
+        std::atomic<bool> _exit;
+        bpf::collection::ArrayList<bpf::memory::UniquePtr<AssetBuildThread>> _workers;
+        bpf::fsize _workerCount[BUILD_STAGE_COUNT];
+        bpf::memory::UniquePtr<AssetBuildCache> _cache;
+        bpf::memory::UniquePtr<AssetTracer> _tracerPtr;
+        std::atomic<AssetTracer *> _tracer; //Read by the workers, only set once
+
+        void StartWorkers(EBuildStage stage, bpf::fsize count);
+        void Enqueue(Entry &&entry);
+        void PushPendingJob(Job *job, EBuildStage stage, EAssetPriority priority);
+        bool PopPendingJob(EBuildStage stage, Job *&job);
+        bool HasOverflow() const noexcept;
+        void FlushOverflow();
+        void WakeWorkers(EBuildStage stage, bool all);
+        void WakeAllWorkers();
+        void ReleaseOwnership(Job *job);
+        void AbandonJob(Job *job);
+        bpf::fsize GetMountableCount() const noexcept;
+        static void Release(Job *job);
+        static EBuildStage GetFirstStage(const Entry &entry) noexcept;
+
+    public:
+        /**
+         * Constructs a new AssetBuildPool
+         * @param workers the number of compute workers, 0 to use the hardware concurrency
+         * @param ioWorkers the number of IO workers, 0 to use GetDefaultIOWorkerCount
+         * @param capacity the capacity of each pending and mountable queue
+         */
+        explicit AssetBuildPool(bpf::fsize workers = 0, bpf::fsize ioWorkers = 0, bpf::fsize capacity = 4096);
+        ~AssetBuildPool();
+        AssetBuildPool(AssetBuildPool &&other) = delete;
+        AssetBuildPool(const AssetBuildPool &other) = delete;
+
+        void Add(const bpf::String &vpath, bpf::memory::UniquePtr<IAssetBuilder> &&ptr, EAssetPriority priority = EAssetPriority::NORMAL);
+
+        /**
+         * Queues a single entry using its own priority
+         */
+        void Add(Entry &&entry);
+
+        /**
+         * Queues all given entries, using their own priority, and wakes up the workers once
+         * @param entries the entries to queue, emptied by this call
+         */
+        void AddBatch(bpf::collection::ArrayList<Entry> &entries);
+
+        /**
+         * Changes the priority of an entry which is still waiting to be built
+         * @return false if no entry with this virtual path is waiting to be built
+         */
+        bool SetPriority(const bpf::Name &vpath, EAssetPriority priority);
+
+        /**
+         * Cancels an entry which is not yet mounted
+         * An entry still waiting to be built is never built, an entry being built has its CancellationToken set
+         * @return false if no entry with this virtual path is pending
+         */
+        bool Cancel(const bpf::Name &vpath);
+
+        /**
+         * Returns the CancellationToken of an entry obtained from WaitPendingEntry
+         */
+        static const CancellationToken &GetCancellationToken(const Entry *entry) noexcept;
+
+        /**
+         * Returns the buffers of an entry obtained from WaitPendingEntry, filled by the IO stage
+         */
+        static bpf::collection::ArrayList<bpf::io::ByteBuf> &GetBuffers(Entry *entry) noexcept;
+
+        /**
+         * Fetches the next built entry, never blocks
+         * @return false if no entry is ready to be mounted
+         */
+        bool PollMountableEntry(Entry &entry);
+
+        /**
+         * Called by the workers to fetch the next entry to process, blocks until an entry is available
+         * @param stage the stage served by the calling worker
+         * @return false if the pool is shutting down
+         */
+        bool WaitPendingEntry(EBuildStage stage, Entry *&entry);
+
+        /**
+         * Called by the IO workers to hand over a read entry to the compute workers
+         */
+        void PushComputeEntry(Entry *entry);
+
+        /**
+         * Called by the workers to hand over a built (or failed) entry to the main thread
+         */
+        void PushMountableEntry(Entry *entry);
+
+        /**
+         * Returns true if some entries are still being built or are waiting to be polled
+         */
+        bool HasPendingWork() const noexcept;
+
+        /**
+         * Returns the number of entries being built or waiting to be polled
+         */
+        bpf::fsize GetPendingCount() const noexcept;
+
+        /**
+         * Blocks the calling thread until an entry is ready to be mounted or until all queued entries have been built
+         */
+        void WaitMountableEntries();
+
+        inline bpf::fsize GetWorkerCount(const EBuildStage stage = EBuildStage::COMPUTE) const noexcept
+        {
+            return (_workerCount[static_cast<bpf::fsize>(stage)]);
+        }
+
+        /**
+         * Installs the build cache, entries with a Source are then looked up before being built and stored after
+         * Must be called before queuing any entry with a Source
+         */
+        inline void SetBuildCache(bpf::memory::UniquePtr<AssetBuildCache> &&cache)
+        {
+            _cache = std::move(cache);
+        }
+
+        /**
+         * Returns the build cache or Null if the build cache is disabled
+         */
+        inline AssetBuildCache *GetBuildCache() const noexcept
+        {
+            return (_cache.Raw());
+        }
+
+        /**
+         * Installs the tracer, the workers then record a span for each build step
+         * Can be called while entries are being built, the tracer is kept until the pool is destroyed
+         * @return false if a tracer is already installed
+         */
+        bool SetTracer(bpf::memory::UniquePtr<AssetTracer> &&tracer);
+
+        /**
+         * Returns the tracer or Null if tracing is disabled
+         */
+        inline AssetTracer *GetTracer() const noexcept
+        {
+            return (_tracer.load(std::memory_order_acquire));
+        }
+
+        static bpf::fsize GetDefaultWorkerCount() noexcept;
+
+        /**
+         * Returns the default number of IO workers, a few concurrent reads are enough to keep a disk busy
+         */
+        static bpf::fsize GetDefaultIOWorkerCount() noexcept;
+
+        AssetBuildPool &operator=(const AssetBuildPool &other) = delete;
+        AssetBuildPool &operator=(AssetBuildPool &&other) = delete;
+    };
+}
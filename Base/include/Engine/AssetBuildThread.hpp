@@ -28,32 +28,22 @@
 
 #pragma once
 #include <Framework/System/Thread.hpp>
-#include <Framework/System/Mutex.hpp>
-#include <Framework/Collection/Queue.hpp>
-#include "Engine/IAssetBuilder.hpp"
+#include "Engine/EBuildStage.hpp"
 
 namespace bp3d
 {
+    //Forward declare the AssetBuildPool to avoid circular dependency between AssetBuildPool and AssetBuildThread
+    class BP3D_API AssetBuildPool;
+
     class BP3D_API AssetBuildThread final : public bpf::system::Thread
     {
-    public:
-        struct Entry
-        {
-            bpf::String VPath;
-            bpf::memory::UniquePtr<IAssetBuilder> Builder;
-            bpf::String Error;
-        };
-
     private:
-        bpf::collection::Queue<Entry> _pendingEntries;
-        bpf::collection::Queue<Entry> _mountableEntries;
-        bpf::system::Mutex _mutex;
+        AssetBuildPool &_pool;
+        EBuildStage _stage;
 
     public:
-        AssetBuildThread();
+        AssetBuildThread(AssetBuildPool &pool, const EBuildStage stage, const bpf::fsize id);
 
-        void Add(const bpf::String &vpath, bpf::memory::UniquePtr<IAssetBuilder> &&ptr);
-        bool PollMountableEntry(Entry &entry);
         void Run();
     };
 }
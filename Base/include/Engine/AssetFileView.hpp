@@ -0,0 +1,195 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <atomic>
+#include <Framework/String.hpp>
+#include <Framework/IO/File.hpp>
+#include <Framework/System/Mutex.hpp>
+#include <Framework/System/Paths.hpp>
+#include <Framework/Collection/HashMap.hpp>
+
+namespace bp3d
+{
+    class BP3D_API AssetFileMapper;
+
+    /**
+     * Shared read-only view of a memory mapped file
+     * Copies share the same mapping, the file is unmapped once the last view is destroyed
+     * Views may be copied and destroyed from any thread, the mapped memory must never be written
+     * A builder can keep its view until its asset is mounted and point TextureDescriptor::Data or BufferDescriptor::Data
+     * straight into the mapped file instead of copying the file content to intermediate buffers
+     */
+    class BP3D_API AssetFileView
+    {
+    public:
+        /**
+         * Identifies the version of a file a mapping was made from
+         */
+        struct FileIdentity
+        {
+            bpf::uint64 Device;
+            bpf::uint64 Inode; //File index on Windows
+            bpf::uint64 Size;
+            bpf::int64 ModifiedTime;
+
+            inline bool operator==(const FileIdentity &other) const noexcept
+            {
+                return (Device == other.Device && Inode == other.Inode && Size == other.Size && ModifiedTime == other.ModifiedTime);
+            }
+        };
+
+        struct Mapping
+        {
+            AssetFileMapper *Owner;
+            bpf::String Path;
+            FileIdentity Identity;
+            const bpf::uint8 *Data;
+            bpf::fsize Size;
+            std::atomic<bpf::fsize> Refs;
+        };
+
+    private:
+        Mapping *_mapping;
+
+        void Release();
+
+    public:
+        /**
+         * Constructs an invalid view
+         */
+        inline AssetFileView() noexcept
+            : _mapping(Null)
+        {
+        }
+
+        /**
+         * Adopts a reference to a mapping, used by AssetFileMapper
+         */
+        explicit inline AssetFileView(Mapping *mapping) noexcept
+            : _mapping(mapping)
+        {
+        }
+
+        inline AssetFileView(const AssetFileView &other) noexcept
+            : _mapping(other._mapping)
+        {
+            if (_mapping != Null)
+                _mapping->Refs.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        inline AssetFileView(AssetFileView &&other) noexcept
+            : _mapping(other._mapping)
+        {
+            other._mapping = Null;
+        }
+
+        inline ~AssetFileView()
+        {
+            Release();
+        }
+
+        AssetFileView &operator=(const AssetFileView &other) noexcept;
+        AssetFileView &operator=(AssetFileView &&other) noexcept;
+
+        /**
+         * Returns false if the file could not be mapped
+         */
+        inline bool IsValid() const noexcept
+        {
+            return (_mapping != Null);
+        }
+
+        /**
+         * Returns the first byte of the file, Null for an empty file
+         */
+        inline const bpf::uint8 *Data() const noexcept
+        {
+            return (_mapping != Null ? _mapping->Data : Null);
+        }
+
+        inline bpf::fsize Size() const noexcept
+        {
+            return (_mapping != Null ? _mapping->Size : 0);
+        }
+
+        inline bpf::String GetPath() const noexcept
+        {
+            return (_mapping != Null ? _mapping->Path : bpf::String::Empty);
+        }
+    };
+
+    /**
+     * Maps asset source files in memory and shares the mappings between all the views of the same file
+     * A file replaced or rewritten since it was mapped is mapped again, views of the previous mapping keep it alive
+     * Thread safe: providers and builders may open views from the build workers
+     * All views must be destroyed before the AssetFileMapper
+     */
+    class BP3D_API AssetFileMapper
+    {
+    private:
+        bpf::system::Mutex _mutex;
+        bpf::collection::HashMap<bpf::String, AssetFileView::Mapping *> _mappings; //File path -> mapping of the current version of the file
+
+        /**
+         * Maps a file unless it is unchanged since current was mapped
+         * @return current if the file did not change, a new mapping or Null if the file could not be mapped
+         */
+        static AssetFileView::Mapping *Map(const bpf::String &path, AssetFileView::Mapping *current);
+        static void Unmap(AssetFileView::Mapping &mapping);
+
+        friend class AssetFileView;
+        void Release(AssetFileView::Mapping *mapping);
+
+    public:
+        AssetFileMapper() = default;
+        ~AssetFileMapper();
+
+        AssetFileMapper(const AssetFileMapper &other) = delete;
+        AssetFileMapper &operator=(const AssetFileMapper &other) = delete;
+
+        /**
+         * Maps a file or shares its existing mapping
+         * @param file the file to map
+         * @return an invalid view if the file could not be opened or mapped
+         */
+        AssetFileView Open(const bpf::io::File &file);
+
+        /**
+         * Maps the file of an asset location, see AssetManager::GetAssetPath
+         * @param paths the application paths used to expand the location
+         * @param location the location part of an asset url, may start with a root variable
+         */
+        AssetFileView Open(const bpf::system::Paths &paths, const bpf::String &location);
+
+        /**
+         * Returns the number of files currently mapped
+         */
+        bpf::fsize GetMappedCount();
+    };
+}
@@ -0,0 +1,100 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <Framework/String.hpp>
+#include <Framework/Name.hpp>
+#include <Framework/IO/File.hpp>
+#include <Framework/System/Paths.hpp>
+#include <Framework/Collection/HashMap.hpp>
+#include <Framework/Collection/ArrayList.hpp>
+
+namespace bp3d
+{
+    /**
+     * Watches the source files of assets and reports the virtual paths of the assets whose file changed
+     * Directories are watched rather than files so that editors replacing files by renaming are detected
+     * Only implemented on Linux (inotify), on other platforms no change is ever reported
+     */
+    class BP3D_API AssetFileWatcher
+    {
+    private:
+        struct DirectoryWatch
+        {
+            int Descriptor;
+            bpf::fsize Files; //Number of watched files in the directory
+        };
+
+        bpf::system::Paths _paths;
+        int _fd;
+        bpf::collection::HashMap<int, bpf::String> _directories; //Watch descriptor -> directory
+        bpf::collection::HashMap<bpf::String, DirectoryWatch> _watches; //Directory -> watch
+        bpf::collection::HashMap<bpf::String, bpf::collection::ArrayList<bpf::Name>> _files; //File path -> virtual paths
+
+    public:
+        /**
+         * Constructs a new AssetFileWatcher
+         * @param paths the application paths used to expand asset locations
+         */
+        explicit AssetFileWatcher(const bpf::system::Paths &paths);
+        ~AssetFileWatcher();
+
+        AssetFileWatcher(const AssetFileWatcher &other) = delete;
+        AssetFileWatcher &operator=(const AssetFileWatcher &other) = delete;
+
+        /**
+         * Returns true if file change notifications are available on this platform
+         */
+        bool IsSupported() const noexcept;
+
+        inline const bpf::system::Paths &GetPaths() const noexcept
+        {
+            return (_paths);
+        }
+
+        /**
+         * Starts watching a file, watching the same file for the same asset again has no effect
+         * @param file the source file of the asset
+         * @param vpath the virtual path of the asset
+         */
+        void Watch(const bpf::io::File &file, const bpf::Name &vpath);
+
+        /**
+         * Stops watching a file for an asset, the directory is no longer watched once none of its files are
+         * @param file the source file of the asset
+         * @param vpath the virtual path of the asset
+         */
+        void Unwatch(const bpf::io::File &file, const bpf::Name &vpath);
+
+        /**
+         * Collects the virtual paths of assets whose file changed since the last call, never blocks
+         * @param changed output list of virtual paths
+         */
+        void Poll(bpf::collection::ArrayList<bpf::Name> &changed);
+    };
+}
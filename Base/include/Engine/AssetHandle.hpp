@@ -0,0 +1,99 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <Framework/Types.hpp>
+
+namespace bp3d
+{
+    /**
+     * Compact reference to an asset slot of an AssetManager
+     * A handle stays valid until the asset is removed, after which the slot generation changes and the handle resolves to the type default
+     */
+    template <typename T>
+    class AssetHandle
+    {
+    private:
+        bpf::uint32 _index;
+        bpf::uint32 _generation;
+
+    public:
+        /**
+         * Constructs an invalid handle
+         */
+        inline AssetHandle() noexcept
+            : _index(0)
+            , _generation(0)
+        {
+        }
+
+        inline AssetHandle(const bpf::uint32 index, const bpf::uint32 generation) noexcept
+            : _index(index)
+            , _generation(generation)
+        {
+        }
+
+        inline bpf::uint32 Index() const noexcept
+        {
+            return (_index);
+        }
+
+        inline bpf::uint32 Generation() const noexcept
+        {
+            return (_generation);
+        }
+
+        /**
+         * Returns true if this handle was issued by an AssetManager, the asset may still have been removed since
+         */
+        inline bool IsValid() const noexcept
+        {
+            return (_generation != 0);
+        }
+
+        /**
+         * Reinterprets this handle for a different asset type
+         * The asset type is checked again when the handle is resolved
+         */
+        template <typename U>
+        inline AssetHandle<U> Cast() const noexcept
+        {
+            return (AssetHandle<U>(_index, _generation));
+        }
+
+        inline bool operator==(const AssetHandle<T> &other) const noexcept
+        {
+            return (_index == other._index && _generation == other._generation);
+        }
+
+        inline bool operator!=(const AssetHandle<T> &other) const noexcept
+        {
+            return (!operator==(other));
+        }
+    };
+}
@@ -0,0 +1,160 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <Framework/Types.hpp>
+#include <Framework/String.hpp>
+#include <Framework/Name.hpp>
+#include <Framework/Collection/HashMap.hpp>
+#include "Engine/AssetUrl.hpp"
+
+namespace bp3d
+{
+    /**
+     * Time spent by an asset in each step of its load, in microseconds
+     */
+    struct BP3D_API AssetTimings
+    {
+        bpf::uint64 QueueWaitMicros = 0; //Waiting for a worker, including between the IO and compute stages
+        bpf::uint64 BuildMicros = 0; //Running the builder, or restoring it from the build cache
+        bpf::uint64 DependencyWaitMicros = 0; //Between the end of the build and the mount: waiting for dependencies or for Poll
+        bpf::uint64 MountMicros = 0; //Running IAssetBuilder::Mount
+
+        AssetTimings &operator+=(const AssetTimings &other) noexcept;
+
+        /**
+         * Returns a monotonic timestamp in microseconds, the reference used by all timings
+         */
+        static bpf::uint64 Now() noexcept;
+    };
+
+    /**
+     * Histogram of durations with power of two buckets, bucket i holds durations of less than 2^i microseconds
+     */
+    class BP3D_API LoadHistogram
+    {
+    public:
+        static constexpr bpf::fsize BUCKET_COUNT = 32;
+
+    private:
+        bpf::uint64 _buckets[BUCKET_COUNT];
+        bpf::uint64 _count;
+        bpf::uint64 _totalMicros;
+        bpf::uint64 _maxMicros;
+
+    public:
+        LoadHistogram() noexcept;
+
+        void Add(bpf::uint64 micros) noexcept;
+
+        inline bpf::uint64 GetCount() const noexcept
+        {
+            return (_count);
+        }
+
+        inline bpf::uint64 GetTotalMicros() const noexcept
+        {
+            return (_totalMicros);
+        }
+
+        inline bpf::uint64 GetMaxMicros() const noexcept
+        {
+            return (_maxMicros);
+        }
+
+        inline bpf::uint64 GetMeanMicros() const noexcept
+        {
+            return (_count == 0 ? 0 : _totalMicros / _count);
+        }
+
+        inline bpf::uint64 GetBucket(bpf::fsize index) const noexcept
+        {
+            return (_buckets[index]);
+        }
+
+        /**
+         * Returns an upper bound of the given percentile, precise to the bucket
+         * @param percentile between 0 and 100
+         */
+        bpf::uint64 GetPercentileMicros(bpf::uint32 percentile) const noexcept;
+    };
+
+    /**
+     * Histograms of the timings of all assets loaded through one provider format
+     */
+    struct BP3D_API FormatLoadStats
+    {
+        bpf::String Format;
+        LoadHistogram QueueWait;
+        LoadHistogram Build;
+        LoadHistogram DependencyWait;
+        LoadHistogram Mount;
+    };
+
+    /**
+     * Aggregated timings of the assets loaded by an AssetManager
+     */
+    class BP3D_API AssetLoadStats
+    {
+    private:
+        bpf::collection::HashMap<bpf::Name, FormatLoadStats> _formats; //Keyed by interned provider token
+        AssetTimings _totals;
+        bpf::uint64 _count;
+
+    public:
+        AssetLoadStats() noexcept;
+
+        void Record(const AssetUrl &url, const AssetTimings &timings);
+
+        inline const bpf::collection::HashMap<bpf::Name, FormatLoadStats> &GetFormats() const noexcept
+        {
+            return (_formats);
+        }
+
+        /**
+         * Returns the histograms of a provider format or Null if no asset was loaded through it
+         * @param provider the interned provider token, see AssetUrl::GetProvider
+         */
+        const FormatLoadStats *GetFormat(const bpf::Name &provider) const noexcept;
+
+        /**
+         * Returns the sum of the timings of all loaded assets
+         */
+        inline const AssetTimings &GetTotals() const noexcept
+        {
+            return (_totals);
+        }
+
+        inline bpf::uint64 GetCount() const noexcept
+        {
+            return (_count);
+        }
+
+        void Clear();
+    };
+}
@@ -28,16 +28,28 @@
 
 #pragma once
 #define BP_COMPAT_2_X
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <Framework/Collection/HashMap.hpp>
 #include <Framework/Memory/UniquePtr.hpp>
 #include <Framework/Memory/ObjectPtr.hpp>
 #include <Framework/TypeInfo.hpp>
-#include <Framework/Log/Logger.hpp>
 #include <Framework/System/Paths.hpp>
 #include <Framework/Collection/List.hpp>
+#include <Framework/Collection/ArrayList.hpp>
+#include <Framework/Collection/Queue.hpp>
 #include "Engine/IAssetProvider.hpp"
 #include "Engine/Asset.hpp"
-#include "Engine/AssetBuildThread.hpp"
+#include "Engine/AssetBuildPool.hpp"
+#include "Engine/AssetHandle.hpp"
+#include "Engine/AssetUrl.hpp"
+#include "Engine/AsyncLogger.hpp"
+#include "Engine/AssetFileView.hpp"
+#include "Engine/AssetRegistry.hpp"
+#include "Engine/AssetPathIndex.hpp"
+#include "Engine/AssetFileWatcher.hpp"
+#include "Engine/EAssetState.hpp"
 
 //Asset url = <asset type>/<format>,(<root>/)<path/to/file.whatever>
 //            [  Asset type info  ],[        Asset location        ]
@@ -45,15 +57,60 @@
 //When registering asset providers specify the format AssetManager.AddProvider<asset::MyAssetType>("mySuperAssetFormat");
 //To load assets:
 //      AssetManager.Add(<asset url>)
+//      The url can be parsed ahead of time with AssetUrl(<asset url>) to skip parsing on every Add
+//      Add returns an AssetHandle which resolves to the asset once it is mounted, AssetManager.Add<asset::MyAssetType>(...) returns a typed handle
 //      New assets are loaded asynchronously so add will append to a pending queue and no asset will immediatly be mounted
+//      An optional EAssetPriority can be passed to Add, higher priorities are built and mounted first
+//      AssetManager.SetPriority(<virtual path>, <priority>) changes the priority of an asset which is not yet mounted
+//      AssetManager.AddBatch(<list of (virtual path, asset url)>) should be preferred when loading many assets at once, it returns the handles in the same order
+//      Builders deriving from StagedAsset split their work in a Read step run by the IO workers and a Compute step run by the build workers
+//Waiting for assets
+//      AssetManager.GetState(<asset handle>) tells whether the asset is pending, mounted or failed
+//      AssetManager.Wait(<asset handle(s)>, <timeout>) polls until the given assets are no longer pending
+//      AssetManager.Then(<asset handle>, <function>) runs a function on the main thread once the asset is mounted or failed
 //Unloading assets
 //      AssetManager.Remove(<virtual path>)
 //      The virtual path can finish by * to request mass unloading of assets
-//      This operation is synchronous and will reset all instances of ObjectPtr to Null
+//      This operation is synchronous and will reset all instances of ObjectPtr to Null, unless a read guard is alive (see Concurrent access)
+//      Assets not yet mounted are cancelled: queued builds never run, running builds see their CancellationToken set
 //      Attemoting to unload an asset set as default for a given type will result in this asset be ignored
+//Memory budget
+//      AssetManager.SetMemoryBudget(<main memory bytes>, <video memory bytes>)
+//      Least recently used assets are evicted when over budget, use Asset.AddUse to keep an asset mounted
+//Hot reload
+//      AssetManager.EnableHotReload(<application paths>)
+//      Assets whose source file changes are rebuilt together with all assets depending on them and swapped in during Poll
+//Build cache
+//      AssetManager.EnableBuildCache(<application paths>)
+//      Builders implementing GetCacheVersion, Serialize and Deserialize skip their build when their source file content is unchanged
+//Concurrent access
+//      AssetManager.Get(AssetManager.BeginRead(), <asset handle>) resolves a handle from any thread without locking
+//      Assets unloaded while a read guard is alive are destroyed once every guard that could have seen them is released
+//Progressive assets
+//      Builders implementing HasRefinement, Refine and Apply mount a coarse version first and are then refined in place during later Polls
+//      Refinements are built and mounted at the lowest priority so that coarse versions of other assets become visible first
+//Memory mapped files
+//      AssetManager.GetFileViews().Open(<application paths>, <location>) maps a source file read-only, views of the same file share one mapping
+//      Builders can hand pointers into the view to the driver at mount time instead of reading the file into intermediate buffers
+//Enumerating assets
+//      AssetManager.ForEach(<virtual path prefix>, <function>)
+//      Both enumeration and mass unloading only visit the assets matching the prefix
+//      AssetManager.ForEach<T>(<function>) sweeps all mounted assets of type T from a packed per-type array
+//Load metrics
+//      AssetManager.GetLoadTimings(<asset handle>) returns the queue wait, build, dependency wait and mount times of an asset
+//      AssetManager.GetLoadStats() returns histograms of these timings per provider format
+//      AssetManager.GetLastPollStats() sums the timings of the assets mounted by the last Poll
+//      AssetManager.EnableTracing(<file>) records build, mount and dependency wait spans and queue depths in the Chrome trace event format
+//Logging
+//      AssetManager.AddLogHandler(<log adapter>), AssetManager.EnableAsyncLogging() formats and dispatches messages on a background thread
+//      Build with BP3D_MIN_LOG_LEVEL (0 = Debug, 1 = Info, 2 = Warning, 3 = Error) to compile out messages below that level
 //Polling
 //      The calling application should call Poll on any asset manager to ensure the proper mounting of newly built assets
-//      The function returns true when no more assets are pending mount
+//      The function returns false when no more assets can be mounted right now
+//      Poll(std::chrono::microseconds) mounts assets until the given time budget is spent and reports the remaining work
+//Dependencies
+//      An asset is only mounted once all the assets returned by IAssetBuilder::GetDependencies are mounted
+//      Dependencies which can never be satisfied (missing or circular) are reported once all builds are finished
 //Asset providers == OK
 //      AssetManager.SetProvider<asset::MyAssetType>(const bpf::String &format, UniquePtr<IAssetProvider<asset::MyAssetType>> &&)
 //      AssetManager.GetProvider<asset::MyAssetType>(const bpf::String &format)
@@ -61,31 +118,210 @@
 //      AssetManager.SetDefault<asset::MyAssetType>(<virtual path>)
 //      AssetManager.GetDefault<asset::MyAssetType>()
 //Getting assets == OK
-//      AssetManager.Get<asset::MyAssetType>(<virtual path>)
+//      AssetManager.Get<asset::MyAssetType>(<asset handle>)
+//      AssetManager.Get<asset::MyAssetType>(<virtual path>) is slower as it requires a hash lookup
+//      AssetManager.GetHandle<asset::MyAssetType>(<virtual path>) returns the handle of an asset, even if it is not yet loaded
 //Injecting existing assets: == OK
 //      AssetManager.Add<asset::MyAssetType>(UniquePtr<asset::MyAssetType> &&)
 
 namespace bp3d
 {
+    struct BP3D_API PollStats
+    {
+        bpf::fsize Mounted; //Number of entries mounted during the call
+        bpf::uint64 ElapsedMicros; //Time spent in the call
+        bpf::fsize Pending; //Number of entries still waiting to be built or mounted
+        AssetTimings Timings; //Sum of the timings of the entries mounted during the call
+    };
+
     class BP3D_API AssetManager
     {
     private:
-        bpf::log::Logger _log;
-        AssetBuildThread _thread;
-        bpf::collection::HashMap<bpf::Name, bpf::memory::UniquePtr<bp3d::Asset>> _mountedAssets;
-        bpf::collection::HashMap<bpf::String, bpf::memory::UniquePtr<IAssetProvider>> _providers;
-        bpf::collection::HashMap<bpf::Name, bpf::Name> _defaults;
-        bpf::collection::List<AssetBuildThread::Entry> _unresolved;
-
-        bool AttemptSolveDependencies();
-    public:
-        inline AssetManager()
-            : _log("AssetManager")
+        AsyncLogger _log;
+        AssetFileMapper _fileViews; //Declared early so that builders and assets holding views are destroyed first
+        AssetRegistry _registry; //Mounted assets readable from any thread, holds the unloaded assets readers may still use
+        struct AssetSlot
+        {
+            bpf::memory::UniquePtr<bp3d::Asset> Ptr; //Null while the asset is not mounted
+            bpf::uint32 Generation; //Incremented each time the slot is released
+            bpf::String VPath;
+            AssetUrl Url; //Invalid for injected assets, which can not be reloaded once evicted
+            EAssetPriority Priority;
+            bpf::fsize CPUSize; //Sizes reported by the asset when it was mounted
+            bpf::fsize GPUSize;
+            bool Evicted;
+            bool Reloading; //True while a new version is being built to replace the mounted one
+            bool ChangedAgain; //True if the source file changed while reloading, another reload follows the current one
+            bool Failed;
+            mutable bool ReloadRequested;
+            bool Linked; //True while the slot is in the LRU list
+            AssetTimings Timings; //Timings of the last build of this asset
+            bpf::uint32 MountSerial; //Incremented each time an asset is mounted in this slot, refinements queued for a previous asset are dropped
+            bpf::uint32 TypeId; //Type of the mounted asset
+            bpf::uint32 TypePos; //Position in the storage of TypeId, NO_SLOT while not mounted
+            mutable bpf::uint32 Prev; //LRU list, most recently used first
+            mutable bpf::uint32 Next;
+
+            inline AssetSlot()
+                : Generation(1) //Generation 0 is reserved for invalid handles
+                , Priority(EAssetPriority::NORMAL)
+                , CPUSize(0)
+                , GPUSize(0)
+                , Evicted(false)
+                , Reloading(false)
+                , ChangedAgain(false)
+                , Failed(false)
+                , ReloadRequested(false)
+                , Linked(false)
+                , MountSerial(0)
+                , TypeId(0)
+                , TypePos(NO_SLOT)
+                , Prev(0)
+                , Next(0)
+            {
+            }
+        };
+
+        bpf::collection::ArrayList<AssetSlot> _slots;
+        bpf::collection::Queue<bpf::uint32> _freeSlots;
+        bpf::collection::HashMap<bpf::Name, bpf::uint32> _slotIndex; //Virtual path -> slot
+        AssetPathIndex _pathIndex; //Slots with a known virtual path, mounted or not
+        mutable bpf::uint32 _lruHead;
+        mutable bpf::uint32 _lruTail;
+        mutable bpf::collection::ArrayList<bpf::uint32> _reloadRequests; //Evicted slots accessed since the last Poll
+        bpf::fsize _cpuBudget;
+        bpf::fsize _gpuBudget;
+        bpf::fsize _cpuUsage;
+        bpf::fsize _gpuUsage;
+        bpf::memory::UniquePtr<AssetFileWatcher> _watcher;
+        bpf::collection::HashMap<bpf::Name, bpf::collection::ArrayList<bpf::Name>> _reverseDependencies; //Dependency -> assets built against it, only with hot reload
+        bpf::collection::HashMap<bpf::Name, bpf::collection::ArrayList<bpf::Name>> _builtAgainst; //Asset -> dependencies it is listed under in _reverseDependencies
+        struct Continuation
+        {
+            bpf::uint32 Generation;
+            std::function<void(Asset *)> Function;
+        };
+
+        bpf::collection::HashMap<bpf::uint32, bpf::collection::ArrayList<Continuation>> _continuations; //Slot -> functions waiting for it
+        bpf::collection::HashMap<bpf::Name, bpf::memory::UniquePtr<IAssetProvider>> _providers; //Keyed by interned provider token (<asset type>/<format>)
+        bpf::collection::ArrayList<AssetHandle<Asset>> _defaults; //Indexed by AssetType identifier
+        //Mounted assets packed per type, pointers are kept apart from slot indices so that typed sweeps only read the pointers
+        struct TypeStorage
+        {
+            bpf::collection::ArrayList<Asset *> Assets;
+            bpf::collection::ArrayList<bpf::uint32> Slots;
+        };
+
+        bpf::collection::ArrayList<TypeStorage> _typeStorage; //Indexed by AssetType identifier
+        struct PendingMount
         {
+            AssetBuildPool::Entry Entry;
+            bpf::fsize Remaining; //Number of dependencies not yet mounted
+        };
+
+        bpf::collection::HashMap<bpf::Name, PendingMount> _unresolved;
+        bpf::collection::HashMap<bpf::Name, bpf::collection::ArrayList<bpf::Name>> _dependents; //Dependency -> unresolved assets waiting on it
+        bpf::collection::Queue<AssetBuildPool::Entry> _mountReady[ASSET_PRIORITY_COUNT];
+        bpf::uint64 _mountCostMicros; //Moving average of the time spent mounting one entry
+        AssetLoadStats _loadStats;
+        PollStats _lastPoll;
+        AssetBuildPool _pool; //Declared last so that workers are stopped before anything they could reference is destroyed
+
+        //Remembers the provider of the last format seen, so that runs of assets sharing a format resolve it once
+        struct ProviderCache
+        {
+            bpf::Name Format;
+            IAssetProvider *Provider = Null;
+        };
+
+        static constexpr bpf::uint32 NO_SLOT = static_cast<bpf::uint32>(-1);
+
+        AssetHandle<Asset> ReserveSlot(const bpf::Name &vpath);
+        AssetHandle<Asset> ReserveSlot(const bpf::String &vpath, const AssetUrl &url, EAssetPriority priority);
+        void ReleaseSlot(const bpf::Name &vpath);
+        AssetHandle<Asset> MountAsset(const bpf::Name &vpath, bpf::memory::UniquePtr<Asset> &&ptr);
+        bool IsMounted(const bpf::Name &vpath) const noexcept;
+        void Link(bpf::uint32 index);
+        void Unlink(bpf::uint32 index) const noexcept;
+        bool IsDefault(bpf::uint32 index) const noexcept;
+        void LinkType(bpf::uint32 index);
+        void UnlinkType(bpf::uint32 index);
+        void Evict(bpf::uint32 index);
+        void EnforceBudget();
+        void Reload(bpf::uint32 index);
+        void ProcessReloadRequests();
+        void ProcessFileChanges();
+        void CancelReload(const bpf::Name &vpath);
+        void ReloadIfChanged(bpf::uint32 index);
+        void RemoveEntry(const bpf::Name &name, const bpf::String &vpath);
+        void CompleteSlot(bpf::uint32 index, Asset *ptr);
+        void FailSlot(const bpf::Name &vpath);
+        void AddContinuation(const AssetHandle<Asset> &handle, std::function<void(Asset *)> &&fn);
+
+        //Moves a slot to the front of the LRU list
+        inline void Touch(const bpf::uint32 index) const noexcept
+        {
+            const auto &slot = _slots[index];
+
+            if (!slot.Linked || _lruHead == index)
+                return;
+            Unlink(index);
+            slot.Prev = NO_SLOT;
+            slot.Next = _lruHead;
+            if (_lruHead != NO_SLOT)
+                _slots[_lruHead].Prev = index;
+            else
+                _lruTail = index;
+            _lruHead = index;
         }
-        inline ~AssetManager()
+
+        inline Asset *Resolve(const AssetHandle<Asset> &handle) const noexcept
+        {
+            if (handle.Index() >= _slots.Size())
+                return (Null);
+            const auto &slot = _slots[handle.Index()];
+            if (slot.Generation != handle.Generation())
+                return (Null);
+            if (slot.Evicted && !slot.ReloadRequested)
+            {
+                slot.ReloadRequested = true;
+                _reloadRequests.Add(handle.Index());
+            }
+            Touch(handle.Index());
+            return (slot.Ptr.Raw());
+        }
+
+        bool CreateEntry(const bpf::String &vpath, const AssetUrl &url, EAssetPriority priority, ProviderCache &cache, AssetBuildPool::Entry &entry);
+        bool ScheduleEntry(AssetBuildPool::Entry &entry);
+        bool IsCurrentEntry(const AssetBuildPool::Entry &entry) const noexcept;
+        bool NextMountableEntry(AssetBuildPool::Entry &entry);
+        AssetTimings MountEntry(AssetBuildPool::Entry &entry);
+        AssetTimings RefineEntry(AssetBuildPool::Entry &entry);
+        void QueueRefinement(const bpf::Name &vpath, AssetBuildPool::Entry &entry);
+        void TraceQueues();
+        void ResolveDependents(const bpf::Name &vpath);
+        void DropUnresolved(const bpf::Name &vpath);
+        void ForgetDependencies(const bpf::Name &vpath);
+        bool HasCircularDependency(const bpf::Name &vpath, bpf::collection::HashMap<bpf::Name, int> &state);
+        bool FailUnresolved();
+    public:
+        /**
+         * Constructs a new AssetManager
+         * @param buildWorkers the number of threads building assets in parallel, 0 to use the hardware concurrency
+         * @param ioWorkers the number of threads reading the sources of staged builders, 0 to use the default
+         */
+        explicit inline AssetManager(bpf::fsize buildWorkers = 0, bpf::fsize ioWorkers = 0)
+            : _log("AssetManager")
+            , _lruHead(NO_SLOT)
+            , _lruTail(NO_SLOT)
+            , _cpuBudget(0)
+            , _gpuBudget(0)
+            , _cpuUsage(0)
+            , _gpuUsage(0)
+            , _mountCostMicros(0)
+            , _lastPoll()
+            , _pool(buildWorkers, ioWorkers)
         {
-            _thread.Join();
         }
         AssetManager(AssetManager &&other) = delete;
         AssetManager(const AssetManager &other) = delete;
@@ -95,26 +331,292 @@ namespace bp3d
          * Asset url = <asset type>/<format>,(<root>/)<path/to/file.whatever>
          *             [  Asset type info  ],[        Asset location        ]
          * @param url Asset url string
+         * @param priority the priority of this asset in the build and mount queues
+         * @return a handle resolving to the asset once it is mounted
+         */
+        AssetHandle<Asset> Add(const bpf::String &vpath, const AssetUrl &url, EAssetPriority priority = EAssetPriority::NORMAL);
+
+        /**
+         * Adds a new asset by url and returns a typed handle
+         * @tparam T the asset type the handle resolves to
+         */
+        template <typename T>
+        inline AssetHandle<T> Add(const bpf::String &vpath, const AssetUrl &url, EAssetPriority priority = EAssetPriority::NORMAL)
+        {
+            return (Add(vpath, url, priority).template Cast<T>());
+        }
+
+        /**
+         * Adds many assets at once
+         * Providers are resolved once per run of assets sharing the same format and build workers are woken up only once
+         * @param assets list of (virtual path, asset url) pairs
+         * @param priority the priority of these assets in the build and mount queues
+         * @return one handle per asset in the order of the list, invalid for assets that could not be added
          */
-        void Add(const bpf::String &vpath, const bpf::String &url);
+        bpf::collection::ArrayList<AssetHandle<Asset>> AddBatch(const bpf::collection::ArrayList<bpf::Tuple<bpf::String, bpf::String>> &assets, EAssetPriority priority = EAssetPriority::NORMAL);
+
+        /**
+         * Changes the priority of an asset which is not yet mounted
+         * @param vpath the virtual path of the asset
+         * @param priority the new priority
+         * @return false if no asset with this virtual path is pending
+         */
+        bool SetPriority(const bpf::Name &vpath, EAssetPriority priority);
+
+        /**
+         * Sets the maximum amount of memory mounted assets may use
+         * When over budget, least recently used assets which are not in use, not a default and loaded by url are evicted during Poll
+         * Evicted assets resolve to the type default and are reloaded as soon as they are requested again
+         * @param cpuBytes main memory budget in bytes, 0 for unlimited
+         * @param gpuBytes video memory budget in bytes, 0 for unlimited
+         */
+        void SetMemoryBudget(bpf::fsize cpuBytes, bpf::fsize gpuBytes);
+
+        /**
+         * Returns the number of bytes of main memory used by mounted assets
+         */
+        inline bpf::fsize GetCPUUsage() const noexcept
+        {
+            return (_cpuUsage);
+        }
+
+        /**
+         * Returns the number of bytes of video memory used by mounted assets
+         */
+        inline bpf::fsize GetGPUUsage() const noexcept
+        {
+            return (_gpuUsage);
+        }
+
+        /**
+         * Enables hot reloading of assets loaded by url from now on
+         * @param paths the application paths used to expand asset locations
+         * @return false if file change notifications are not available on this platform
+         */
+        bool EnableHotReload(const bpf::system::Paths &paths);
+
+        /**
+         * Enables the on-disk build cache for assets loaded by url from now on
+         * Builders returning a non-zero IAssetBuilder::GetCacheVersion are restored from the cache instead of being built when their source file is unchanged
+         * @param paths the application paths used to expand asset locations, blobs are stored in the Assets folder of the cache directory
+         * Calling this function again once the cache is enabled has no effect
+         * @return false if the cache directory could not be created
+         */
+        bool EnableBuildCache(const bpf::system::Paths &paths);
+
+        /**
+         * Starts recording asset loading to a trace file viewable in chrome://tracing or Perfetto
+         * Events are written by a background thread, the file is completed when the AssetManager is destroyed
+         * Calling this function again once tracing is enabled has no effect
+         * @param file the trace file, overwritten
+         * @return false if the trace file could not be opened
+         */
+        bool EnableTracing(const bpf::io::File &file);
+
+        /**
+         * Blocks until all recorded trace events have been written to the trace file
+         */
+        inline void FlushTrace()
+        {
+            if (_pool.GetTracer() != Null)
+                _pool.GetTracer()->Flush();
+        }
 
         inline void AddLogHandler(bpf::memory::UniquePtr<bpf::log::ILogAdapter> &&ptr)
         {
             _log.AddHandler(std::move(ptr));
         }
 
+        /**
+         * Moves log formatting and dispatch to a background thread, handlers are then called from that thread
+         * @param capacity the number of messages which can be queued before logging blocks
+         */
+        inline void EnableAsyncLogging(bpf::fsize capacity = 4096)
+        {
+            _log.EnableAsync(capacity);
+        }
+
+        /**
+         * Blocks until all queued log messages have been dispatched to the handlers
+         */
+        inline void FlushLogs()
+        {
+            _log.Flush();
+        }
+
+        /**
+         * Returns the shared memory mapped views of asset files, may be used from the build workers
+         * Providers typically keep a reference to it and open the location they are given with AssetFileMapper::Open
+         */
+        inline AssetFileMapper &GetFileViews() noexcept
+        {
+            return (_fileViews);
+        }
+
         static bpf::io::File GetAssetPath(const bpf::system::Paths &paths, const bpf::String &location);
 
         template <typename T>
-        inline void Add(bpf::memory::UniquePtr<Asset> &&ptr)
+        inline AssetHandle<T> Add(bpf::memory::UniquePtr<Asset> &&ptr)
+        {
+            auto name = ptr->HashCode();
+            return (MountAsset(name, std::move(ptr)).template Cast<T>());
+        }
+
+        /**
+         * Returns the handle of an asset, the handle resolves to the asset as soon as it is mounted
+         * @param vpath the virtual path of the asset
+         */
+        template <typename T>
+        inline AssetHandle<T> GetHandle(const bpf::Name &vpath)
         {
-            _mountedAssets.Add(ptr->HashCode(), ptr);
+            return (ReserveSlot(vpath).template Cast<T>());
         }
 
         void Remove(const bpf::String &vpath);
 
+        /**
+         * Calls fn for each mounted asset whose virtual path starts with the given prefix
+         * Assets must not be added or removed from within fn
+         * @param prefix the virtual path prefix, an empty prefix matches all assets
+         * @param fn function taking an Asset &
+         */
+        template <typename Function>
+        inline void ForEach(const bpf::String &prefix, Function &&fn)
+        {
+            _pathIndex.ForEach(prefix, [&](const bpf::uint32 slot) {
+                if (_slots[slot].Ptr != Null)
+                    fn(*_slots[slot].Ptr);
+            });
+        }
+
+        /**
+         * Calls fn for each mounted asset of type T
+         * Assets are read from a packed per-type array, in no particular order, without any lookup or type check
+         * Assets of types derived from T are not visited, assets must not be added or removed from within fn
+         * @param fn function taking a T &
+         */
+        template <typename T, typename Function>
+        inline void ForEach(Function &&fn)
+        {
+            auto id = AssetType::Id<T>();
+
+            if (id >= _typeStorage.Size())
+                return;
+            auto &assets = _typeStorage[id].Assets;
+            for (bpf::fsize i = 0; i != assets.Size(); ++i)
+                fn(*static_cast<T *>(assets[i]));
+        }
+
+        /**
+         * Returns the number of mounted assets of type T
+         */
+        template <typename T>
+        inline bpf::fsize GetMountedCount() const noexcept
+        {
+            auto id = AssetType::Id<T>();
+
+            return (id < _typeStorage.Size() ? _typeStorage[id].Assets.Size() : 0);
+        }
+
+        /**
+         * Mounts newly built assets, must be called on the main thread
+         * @param maxMountable maximum number of built entries to process
+         * @return true if more entries may be mounted immediately
+         */
         bool Poll(bpf::fsize maxMountable = 1);
 
+        /**
+         * Mounts newly built assets until the given time budget is spent, must be called on the main thread
+         * Each mount is timed, no new mount is started when the average mount cost no longer fits in the remaining budget
+         * At least one entry is always mounted, if available, to guarantee progress
+         * @param budget maximum time to spend mounting assets
+         * @return statistics about this call and the remaining work
+         */
+        PollStats Poll(std::chrono::microseconds budget);
+
+        /**
+         * Returns the statistics of the last call to either version of Poll
+         */
+        inline const PollStats &GetLastPollStats() const noexcept
+        {
+            return (_lastPoll);
+        }
+
+        /**
+         * Returns the timing histograms of all assets built and mounted so far, per provider format
+         */
+        inline const AssetLoadStats &GetLoadStats() const noexcept
+        {
+            return (_loadStats);
+        }
+
+        inline void ResetLoadStats()
+        {
+            _loadStats.Clear();
+        }
+
+        /**
+         * Returns the timings of the last load of an asset, all zero if the asset was never built
+         */
+        AssetTimings GetLoadTimings(const AssetHandle<Asset> &handle) const noexcept;
+
+        /**
+         * Returns the loading state of an asset, a handle reserved with GetHandle but never loaded stays pending
+         */
+        EAssetState GetState(const AssetHandle<Asset> &handle) const noexcept;
+
+        template <typename T>
+        inline EAssetState GetState(const AssetHandle<T> &handle) const noexcept
+        {
+            return (GetState(handle.template Cast<Asset>()));
+        }
+
+        /**
+         * Polls on the main thread until an asset is no longer pending
+         * Other assets are mounted as well while waiting
+         * @param handle the asset to wait for
+         * @param timeout maximum time to wait
+         * @return false if the asset is still pending after the timeout
+         */
+        bool Wait(const AssetHandle<Asset> &handle, std::chrono::milliseconds timeout);
+
+        template <typename T>
+        inline bool Wait(const AssetHandle<T> &handle, std::chrono::milliseconds timeout)
+        {
+            return (Wait(handle.template Cast<Asset>(), timeout));
+        }
+
+        /**
+         * Polls on the main thread until none of the given assets is pending
+         * @param handles the assets to wait for
+         * @param timeout maximum time to wait
+         * @return false if some assets are still pending after the timeout
+         */
+        bool Wait(const bpf::collection::ArrayList<AssetHandle<Asset>> &handles, std::chrono::milliseconds timeout);
+
+        /**
+         * Registers a function to run on the main thread, during Poll, once an asset is mounted
+         * The function runs immediately if the asset is already mounted and receives Null if the asset failed or was removed
+         * @param handle the asset to wait for
+         * @param fn function taking a T *, may be move-only
+         */
+        template <typename T, typename Function>
+        inline void Then(const AssetHandle<T> &handle, Function &&fn)
+        {
+            //The callable is moved into a shared holder: std::function requires a copyable target
+            auto holder = std::make_shared<typename std::decay<Function>::type>(std::forward<Function>(fn));
+            AddContinuation(handle.template Cast<Asset>(), [fn = std::move(holder)](Asset *ptr) mutable {
+                if (ptr != Null && ptr->TypeId() != AssetType::Id<T>())
+                    ptr = Null;
+                (*fn)(static_cast<T *>(ptr));
+            });
+        }
+
+        /**
+         * Returns the number of entries still waiting to be built or mounted
+         */
+        bpf::fsize GetPendingCount() const noexcept;
+
         /**
          * Yields the main thread waiting for all pending asset objects to be mounted
          */
@@ -123,40 +625,90 @@ namespace bp3d
         template <typename T>
         inline void SetProvider(const bpf::String &format, bpf::memory::UniquePtr<IAssetProvider> &&ptr)
         {
-            _providers.Add(bpf::String(bpf::TypeName<T>()) + '/' + format, std::move(ptr));
+            _providers.Add(bpf::Name(bpf::String(bpf::TypeName<T>()) + '/' + format), std::move(ptr));
+        }
+
+        /**
+         * Returns the provider of an interned provider token, see AssetUrl::GetProvider
+         */
+        inline bpf::memory::UniquePtr<IAssetProvider> &GetProvider(const bpf::Name &provider)
+        {
+            return (_providers[provider]);
         }
 
-        inline bpf::memory::UniquePtr<IAssetProvider> &GetProvider(const bpf::String &format)
+        /**
+         * Resolves an asset handle
+         * @return the asset or the default asset of type T if the handle is stale, not yet mounted or of a different type
+         */
+        template <typename T>
+        inline bpf::memory::ObjectPtr<T> Get(const AssetHandle<T> &handle) const noexcept
         {
-            return (_providers[format]);
+            auto ptr = Resolve(handle.template Cast<Asset>());
+
+            if (ptr == Null || ptr->TypeId() != AssetType::Id<T>())
+                return (GetDefault<T>());
+            return (static_cast<T *>(ptr));
         }
 
         template <typename T>
         inline bpf::memory::ObjectPtr<T> Get(const bpf::Name &vpath) const noexcept
         {
-            if (!_mountedAssets.HasKey(vpath) || _mountedAssets[vpath]->Type() != bpf::Name(bpf::TypeName<T>()))
+            if (!_slotIndex.HasKey(vpath))
                 return (GetDefault<T>());
-            return (static_cast<T *>(_mountedAssets[vpath].Raw()));
+            auto index = _slotIndex[vpath];
+            return (Get<T>(AssetHandle<T>(index, _slots[index].Generation)));
+        }
+
+        /**
+         * Starts reading mounted assets from any thread, see Get(const AssetReadGuard &, const AssetHandle<T> &)
+         * Thread safe and lock-free
+         */
+        inline AssetReadGuard BeginRead() const noexcept
+        {
+            return (AssetReadGuard(_registry));
+        }
+
+        /**
+         * Resolves an asset handle from any thread without locking, while the main thread keeps polling and removing assets
+         * Unlike the main thread Get, there is no fallback to the default asset, the LRU order is not updated
+         * and evicted assets are not reloaded
+         * Asset::AddUse and Asset::RemoveUse may be called on the returned asset to keep it from being evicted
+         * @param guard a guard obtained from BeginRead on this AssetManager, the asset stays alive until the guard is destroyed
+         * @return the asset or Null if the handle is stale, the asset is not mounted or is of a different type
+         */
+        template <typename T>
+        inline T *Get(const AssetReadGuard &guard, const AssetHandle<T> &handle) const noexcept
+        {
+            auto ptr = _registry.Resolve(guard, handle.template Cast<Asset>());
+
+            if (ptr == Null || ptr->TypeId() != AssetType::Id<T>())
+                return (Null);
+            return (static_cast<T *>(ptr));
         }
 
         template <typename T>
         inline bpf::memory::ObjectPtr<T> GetDefault() const noexcept
         {
-            auto tname = bpf::Name(bpf::TypeName<T>());
+            auto id = AssetType::Id<T>();
 
-            if (!_defaults.HasKey(tname))
+            if (id >= _defaults.Size())
                 return (Null); //We have no default registered
-            return (static_cast<T *>(_mountedAssets[_defaults[tname]].Raw()));
+            return (static_cast<T *>(Resolve(_defaults[id])));
         }
 
         template <typename T>
         inline void SetDefault(const bpf::Name &vpath)
         {
-            auto tname = bpf::Name(bpf::TypeName<T>());
+            auto id = AssetType::Id<T>();
 
-            if (!_mountedAssets.HasKey(vpath) || _mountedAssets[vpath]->Type() != tname)
+            if (!IsMounted(vpath))
+                return;
+            auto index = _slotIndex[vpath];
+            if (_slots[index].Ptr->TypeId() != id)
                 return;
-            _defaults[tname] = vpath; //Will update or create entry in defaults map
+            if (id >= _defaults.Size())
+                _defaults.Resize(id + 1); //New slots hold invalid handles
+            _defaults[id] = AssetHandle<Asset>(index, _slots[index].Generation);
         }
 
         AssetManager &operator=(const AssetManager &other) = delete;
@@ -0,0 +1,128 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <Framework/String.hpp>
+#include <Framework/Collection/HashMap.hpp>
+#include <Framework/Collection/ArrayList.hpp>
+#include <Framework/Memory/UniquePtr.hpp>
+
+namespace bp3d
+{
+    /**
+     * Hierarchical index of virtual paths split on '/'
+     * Enumerating all paths starting with a given prefix only visits the matching subtrees
+     */
+    class BP3D_API AssetPathIndex
+    {
+    private:
+        struct Node
+        {
+            bpf::collection::HashMap<bpf::String, bpf::memory::UniquePtr<Node>> Children;
+            bpf::uint32 Slot;
+            bool HasSlot;
+
+            inline Node()
+                : Slot(0)
+                , HasSlot(false)
+            {
+            }
+        };
+
+        Node _root;
+        bpf::fsize _size;
+
+        bool Remove(Node &node, const bpf::collection::ArrayList<bpf::String> &segments, bpf::fsize depth);
+
+        template <typename Function>
+        static void Visit(const Node &node, Function &fn)
+        {
+            if (node.HasSlot)
+                fn(node.Slot);
+            for (auto &child : node.Children)
+                Visit(*child.Value, fn);
+        }
+
+    public:
+        inline AssetPathIndex()
+            : _size(0)
+        {
+        }
+
+        /**
+         * Inserts or updates a path
+         * @param vpath the virtual path
+         * @param slot the value associated with this path
+         */
+        void Insert(const bpf::String &vpath, bpf::uint32 slot);
+
+        /**
+         * Removes a path
+         * @param vpath the virtual path
+         * @return false if the path was not in the index
+         */
+        bool Remove(const bpf::String &vpath);
+
+        /**
+         * Calls fn with the value of each path starting with the given prefix
+         * The prefix may end in the middle of a path segment
+         * @param prefix the prefix to match, an empty prefix matches all paths
+         * @param fn function taking the value of a path as a bpf::uint32
+         */
+        template <typename Function>
+        void ForEach(const bpf::String &prefix, Function &&fn) const
+        {
+            const Node *node = &_root;
+            auto last = prefix.LastIndexOf('/');
+
+            if (last >= 0)
+            {
+                for (auto &segment : prefix.Sub(0, last).Explode('/'))
+                {
+                    if (!node->Children.HasKey(segment))
+                        return;
+                    node = node->Children[segment].Raw();
+                }
+            }
+            auto partial = prefix.Sub(last + 1);
+            for (auto &child : node->Children)
+            {
+                if (child.Key.StartsWith(partial))
+                    Visit(*child.Value, fn);
+            }
+        }
+
+        /**
+         * Returns the number of paths in this index
+         */
+        inline bpf::fsize Size() const noexcept
+        {
+            return (_size);
+        }
+    };
+}
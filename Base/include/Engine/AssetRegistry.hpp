@@ -0,0 +1,167 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <atomic>
+#include <Framework/Memory/UniquePtr.hpp>
+#include <Framework/Collection/Queue.hpp>
+#include "Engine/Asset.hpp"
+#include "Engine/AssetHandle.hpp"
+
+namespace bp3d
+{
+    class BP3D_API AssetRegistry;
+
+    /**
+     * Pins the mounted assets of an AssetRegistry for the calling thread
+     * Assets resolved through the guard are not destroyed before the guard is, even if they are removed or replaced meanwhile
+     * Guards should be short lived (one job, one draw list...) as they delay the destruction of unloaded assets
+     */
+    class BP3D_API AssetReadGuard
+    {
+    private:
+        const AssetRegistry *_registry;
+        bpf::fsize _participant;
+
+    public:
+        AssetReadGuard(const AssetRegistry &registry) noexcept;
+        ~AssetReadGuard();
+
+        inline AssetReadGuard(AssetReadGuard &&other) noexcept
+            : _registry(other._registry)
+            , _participant(other._participant)
+        {
+            other._registry = Null;
+        }
+
+        AssetReadGuard(const AssetReadGuard &other) = delete;
+        AssetReadGuard &operator=(const AssetReadGuard &other) = delete;
+        AssetReadGuard &operator=(AssetReadGuard &&other) = delete;
+
+        inline const AssetRegistry *GetRegistry() const noexcept
+        {
+            return (_registry);
+        }
+    };
+
+    /**
+     * Read-optimized mirror of the mounted assets, resolvable from any thread without locking
+     * Written by the main thread only: mounting publishes the asset of a slot, unloading unpublishes it and retires the asset
+     * Retired assets are destroyed using epoch based reclamation: immediately when no reader is active, otherwise by Reclaim
+     * once every reader which could have seen them has released its AssetReadGuard
+     */
+    class BP3D_API AssetRegistry
+    {
+    public:
+        static constexpr bpf::fsize CHUNK_SIZE = 1024;
+        static constexpr bpf::fsize MAX_CHUNKS = 4096; //Slots past MAX_CHUNKS * CHUNK_SIZE are never published
+        static constexpr bpf::fsize MAX_PARTICIPANTS = 64; //Maximum number of concurrent guards, further guards spin
+
+    private:
+        struct Entry
+        {
+            std::atomic<Asset *> Ptr;
+            std::atomic<bpf::uint32> Generation;
+        };
+
+        struct Chunk
+        {
+            Entry Entries[CHUNK_SIZE];
+
+            Chunk();
+        };
+
+        //Epoch of an active guard, 0 when the participant is free
+        struct alignas(64) Participant
+        {
+            std::atomic<bpf::uint64> Epoch;
+        };
+
+        struct Retired
+        {
+            bpf::memory::UniquePtr<Asset> Ptr;
+            bpf::uint64 Epoch;
+        };
+
+        std::atomic<Chunk *> _chunks[MAX_CHUNKS];
+        mutable Participant _participants[MAX_PARTICIPANTS];
+        std::atomic<bpf::uint64> _epoch;
+        bpf::collection::Queue<Retired> _retired; //Main thread only, ordered by epoch
+
+        bool HasReaders() const noexcept;
+        bool TryAdvanceEpoch() noexcept;
+
+        friend class AssetReadGuard;
+        bpf::fsize Pin() const noexcept;
+        void Unpin(bpf::fsize participant) const noexcept;
+
+    public:
+        AssetRegistry();
+
+        /**
+         * Destroys all retired assets, no guard may be alive
+         */
+        ~AssetRegistry();
+
+        AssetRegistry(const AssetRegistry &other) = delete;
+        AssetRegistry &operator=(const AssetRegistry &other) = delete;
+
+        /**
+         * Publishes the asset of a slot, main thread only
+         * @param index the slot index
+         * @param generation the current generation of the slot
+         * @param ptr the mounted asset or Null
+         */
+        void Publish(bpf::uint32 index, bpf::uint32 generation, Asset *ptr);
+
+        /**
+         * Destroys an asset once no reader can access it anymore, main thread only
+         * The asset must have been unpublished or replaced first
+         */
+        void Retire(bpf::memory::UniquePtr<Asset> ptr);
+
+        /**
+         * Destroys the retired assets which are no longer reachable by any reader, main thread only
+         */
+        void Reclaim();
+
+        /**
+         * Returns the number of retired assets waiting to be destroyed
+         */
+        inline bpf::fsize GetRetiredCount() const noexcept
+        {
+            return (_retired.Size());
+        }
+
+        /**
+         * Resolves a handle from any thread
+         * @return the asset or Null if the handle is stale or the asset is not mounted
+         */
+        Asset *Resolve(const AssetReadGuard &guard, const AssetHandle<Asset> &handle) const noexcept;
+    };
+}
@@ -0,0 +1,132 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <atomic>
+#include <Framework/String.hpp>
+#include <Framework/IO/File.hpp>
+#include <Framework/IO/FileStream.hpp>
+#include <Framework/Memory/UniquePtr.hpp>
+#include <Framework/System/Thread.hpp>
+#include "Engine/RingQueue.hpp"
+
+namespace bp3d
+{
+    /**
+     * Records asset pipeline events to a file in the Chrome trace event format (chrome://tracing, Perfetto)
+     * Events are pushed to a lock-free ring buffer and serialized by a background writer which batches file writes,
+     * events are dropped rather than blocking the caller when the ring buffer is full
+     * All timestamps are in microseconds, see AssetTimings::Now
+     */
+    class BP3D_API AssetTracer
+    {
+    public:
+        struct Event
+        {
+            const char *Name = Null; //Static string
+            char Phase = 'X';
+            bpf::uint32 ThreadId = 0;
+            bpf::uint64 Timestamp = 0;
+            bpf::uint64 Value = 0; //Duration of complete events, value of counters, id of async events
+            bpf::String Detail; //Virtual path of the asset
+        };
+
+    private:
+        class Writer;
+
+        bpf::io::File _file;
+        bpf::memory::UniquePtr<bpf::io::FileStream> _stream;
+        RingQueue<Event> _events;
+        bpf::memory::UniquePtr<bpf::system::Thread> _writer;
+        bpf::String _buffer; //Writer thread only: serialized events not yet written to the file
+        std::atomic<bpf::uint64> _pending; //Number of events pushed but not yet serialized
+        std::atomic<bpf::uint64> _dropped;
+        std::atomic<bpf::uint64> _nextId;
+        std::atomic<bool> _flushRequested;
+        std::atomic<bool> _exit;
+
+        void Push(Event &event);
+        bool WriteEvents();
+        void WriteBuffer();
+
+    public:
+        /**
+         * Constructs a new AssetTracer, no file is opened until Start is called
+         * @param file the trace file, overwritten
+         * @param capacity the capacity of the ring buffer
+         */
+        explicit AssetTracer(const bpf::io::File &file, bpf::fsize capacity = 65536);
+
+        /**
+         * Writes all pending events and terminates the trace file
+         */
+        ~AssetTracer();
+
+        AssetTracer(const AssetTracer &other) = delete;
+        AssetTracer &operator=(const AssetTracer &other) = delete;
+
+        /**
+         * Opens the trace file and starts the background writer
+         * @return false if the trace file could not be opened
+         */
+        bool Start();
+
+        /**
+         * Records a span of work on the calling thread
+         */
+        void Span(const char *name, const bpf::String &detail, bpf::uint64 start, bpf::uint64 end);
+
+        /**
+         * Records a span which is not bound to a thread, such as an asset waiting for its dependencies
+         */
+        void AsyncSpan(const char *name, const bpf::String &detail, bpf::uint64 start, bpf::uint64 end);
+
+        /**
+         * Records the value of a counter
+         */
+        void Counter(const char *name, bpf::uint64 timestamp, bpf::uint64 value);
+
+        /**
+         * Blocks until all recorded events are written to the trace file
+         */
+        void Flush();
+
+        /**
+         * Returns the number of events dropped because the ring buffer was full
+         */
+        inline bpf::uint64 GetDroppedCount() const noexcept
+        {
+            return (_dropped.load(std::memory_order_relaxed));
+        }
+
+        /**
+         * Returns a small integer identifying the calling thread in traces
+         */
+        static bpf::uint32 GetThreadId() noexcept;
+    };
+}
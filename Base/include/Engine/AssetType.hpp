@@ -0,0 +1,63 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <Framework/Types.hpp>
+#include <Framework/Name.hpp>
+#include <Framework/TypeInfo.hpp>
+
+namespace bp3d
+{
+    /**
+     * Dense integer identifiers for asset types
+     * Identifiers are allocated in registration order starting at 0, so they can index flat per-type tables
+     * A given type name always maps to the same identifier, even across modules
+     */
+    class BP3D_API AssetType
+    {
+    public:
+        /**
+         * Returns the identifier of a type name, allocating a new one on first use
+         * This function is thread safe but takes a lock, prefer Id<T>() which caches the result
+         * @param type the type name
+         */
+        static bpf::uint32 Register(const bpf::Name &type);
+
+        /**
+         * Returns the number of identifiers allocated so far
+         */
+        static bpf::uint32 GetCount() noexcept;
+
+        template <typename T>
+        inline static bpf::uint32 Id() noexcept
+        {
+            static const bpf::uint32 id = Register(bpf::Name(bpf::TypeName<T>()));
+            return (id);
+        }
+    };
+}
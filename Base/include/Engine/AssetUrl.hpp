@@ -0,0 +1,137 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <Framework/String.hpp>
+#include <Framework/Name.hpp>
+#include <Framework/IO/File.hpp>
+#include <Framework/System/Paths.hpp>
+#include "Engine/EAssetRoot.hpp"
+
+namespace bp3d
+{
+    /**
+     * A parsed asset url: <asset type>/<format>,(<root>/)<path/to/file.whatever>
+     * The url is parsed once on construction: the provider token is interned and the root variable is recognized,
+     * so that looking up the provider and resolving the source file no longer need to split or search the url
+     */
+    class BP3D_API AssetUrl
+    {
+    private:
+        bpf::String _format;
+        bpf::String _location;
+        bpf::Name _provider;
+        EAssetRoot _root;
+        bpf::fisize _pathStart;
+
+        static EAssetRoot ParseRoot(const bpf::String &location, bpf::fisize &pathStart);
+        static bpf::io::File Resolve(const bpf::system::Paths &paths, const bpf::String &location, EAssetRoot root, bpf::fisize pathStart);
+
+    public:
+        /**
+         * Constructs an invalid url
+         */
+        AssetUrl();
+
+        /**
+         * Parses an asset url, the result is invalid if the url does not contain exactly one ','
+         * An invalid url keeps the original text as its location for error reporting
+         */
+        AssetUrl(const bpf::String &url);
+
+        inline AssetUrl(const char *url)
+            : AssetUrl(bpf::String(url))
+        {
+        }
+
+        inline bool IsValid() const noexcept
+        {
+            return (_format != bpf::String::Empty);
+        }
+
+        /**
+         * Returns the provider token (<asset type>/<format>)
+         */
+        inline const bpf::String &GetFormat() const noexcept
+        {
+            return (_format);
+        }
+
+        /**
+         * Returns the interned provider token, the key of providers in the AssetManager
+         */
+        inline const bpf::Name &GetProvider() const noexcept
+        {
+            return (_provider);
+        }
+
+        /**
+         * Returns the location as passed to IAssetProvider::Create, including the root variable
+         */
+        inline const bpf::String &GetLocation() const noexcept
+        {
+            return (_location);
+        }
+
+        inline EAssetRoot GetRoot() const noexcept
+        {
+            return (_root);
+        }
+
+        /**
+         * Returns the url as originally written
+         */
+        bpf::String ToString() const;
+
+        /**
+         * Expands the root variable of the location
+         * A leading root variable is parsed once by the constructor, root variables elsewhere in the location are also expanded
+         * @param paths the application paths
+         * @return the source file of the asset
+         */
+        inline bpf::io::File Resolve(const bpf::system::Paths &paths) const
+        {
+            return (Resolve(paths, _location, _root, _pathStart));
+        }
+
+        /**
+         * Expands the root variable of a location which was not parsed ahead of time
+         * @param paths the application paths
+         * @param location an asset location ((<root>/)<path/to/file.whatever>)
+         * @return the source file of the asset
+         */
+        static bpf::io::File Resolve(const bpf::system::Paths &paths, const bpf::String &location);
+    };
+    /**
+     * Lets AsyncLogger format urls lazily, see ToLogArg
+     */
+    inline bpf::String ToLogArg(const AssetUrl &url)
+    {
+        return (url.ToString());
+    }
+}
@@ -0,0 +1,259 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <Framework/String.hpp>
+#include <Framework/Log/ILogAdapter.hpp>
+#include <Framework/Memory/UniquePtr.hpp>
+#include <Framework/Collection/ArrayList.hpp>
+#include <Framework/System/Mutex.hpp>
+#include <Framework/System/ConditionVariable.hpp>
+#include <Framework/System/Thread.hpp>
+#include "Engine/RingQueue.hpp"
+
+#ifndef BP3D_MIN_LOG_LEVEL
+    //Minimum level of the messages compiled in: 0 = Debug, 1 = Info, 2 = Warning, 3 = Error
+    #define BP3D_MIN_LOG_LEVEL 0
+#endif
+
+namespace bp3d
+{
+    /**
+     * Converts a log argument to a value accepted by bpf::String::Format
+     * Overload this function in the namespace of a type to log values of that type
+     */
+    template <typename T>
+    inline const T &ToLogArg(const T &value) noexcept
+    {
+        return (value);
+    }
+
+    /**
+     * Logger deferring message formatting and handler dispatch to a background thread
+     * Calls only copy the format string pointer and the raw arguments to a lock-free ring buffer, format strings must therefore be literals
+     * Messages are formatted and dispatched synchronously until EnableAsync is called
+     * Messages below BP3D_MIN_LOG_LEVEL are compiled out, their arguments are never formatted
+     */
+    class BP3D_API AsyncLogger
+    {
+    public:
+        //Size of the raw arguments stored inline in a record, larger argument lists are formatted by the caller
+        static constexpr bpf::fsize ARGS_SIZE = 128;
+
+        /**
+         * A queued message: the level, the format string and a type-erased tuple of arguments
+         */
+        class BP3D_API Record
+        {
+        private:
+            struct Ops
+            {
+                void (*Move)(void *dst, void *src);
+                void (*Destroy)(void *args);
+                bpf::String (*Format)(const char *format, const void *args);
+            };
+
+            template <typename Tuple>
+            struct TupleOps
+            {
+                static void Move(void *dst, void *src)
+                {
+                    new (dst) Tuple(std::move(*static_cast<Tuple *>(src)));
+                }
+
+                static void Destroy(void *args)
+                {
+                    static_cast<Tuple *>(args)->~Tuple();
+                }
+
+                static bpf::String Format(const char *format, const void *args)
+                {
+                    return (std::apply([format](const auto &...values) { return (bpf::String::Format(format, ToLogArg(values)...)); },
+                                       *static_cast<const Tuple *>(args)));
+                }
+
+                static constexpr Ops TABLE = {&Move, &Destroy, &Format};
+            };
+
+            const Ops *_ops;
+            bpf::log::ELogLevel _level;
+            const char *_format;
+            alignas(std::max_align_t) bpf::uint8 _args[ARGS_SIZE];
+
+        public:
+            inline Record()
+                : _ops(Null)
+                , _level(bpf::log::ELogLevel::INFO)
+                , _format(Null)
+            {
+            }
+
+            inline ~Record()
+            {
+                Reset();
+            }
+
+            Record(const Record &other) = delete;
+            Record &operator=(const Record &other) = delete;
+
+            Record &operator=(Record &&other) noexcept;
+
+            template <typename... Args>
+            void Set(bpf::log::ELogLevel level, const char *format, const Args &...args)
+            {
+                using Tuple = std::tuple<std::decay_t<Args>...>;
+
+                Reset();
+                _level = level;
+                if constexpr (sizeof(Tuple) <= ARGS_SIZE && alignof(Tuple) <= alignof(std::max_align_t))
+                {
+                    new (_args) Tuple(args...);
+                    _ops = &TupleOps<Tuple>::TABLE;
+                    _format = format;
+                }
+                else
+                {
+                    using Formatted = std::tuple<bpf::String>;
+                    new (_args) Formatted(bpf::String::Format(format, ToLogArg(args)...));
+                    _ops = &TupleOps<Formatted>::TABLE;
+                    _format = "[]";
+                }
+            }
+
+            inline bpf::log::ELogLevel GetLevel() const noexcept
+            {
+                return (_level);
+            }
+
+            inline bpf::String ToString() const
+            {
+                return (_ops->Format(_format, _args));
+            }
+
+            void Reset() noexcept;
+        };
+
+    private:
+        class Worker;
+
+        bpf::String _category;
+        bpf::collection::ArrayList<bpf::memory::UniquePtr<bpf::log::ILogAdapter>> _handlers;
+        bpf::system::Mutex _handlersMutex;
+        bpf::memory::UniquePtr<RingQueue<Record>> _queue;
+        bpf::memory::UniquePtr<bpf::system::Thread> _worker;
+        bpf::system::Mutex _mutex;
+        bpf::system::ConditionVariable _cond;
+        std::atomic<bpf::fsize> _pending; //Number of records pushed but not yet dispatched
+        std::atomic<bool> _sleeping;
+        std::atomic<bool> _exit;
+
+        void Push(Record &record);
+        bool WaitRecord(Record &record);
+        void Dispatch(bpf::log::ELogLevel level, const bpf::String &msg);
+
+        template <typename... Args>
+        inline void Log(bpf::log::ELogLevel level, const char *format, const Args &...args)
+        {
+            if (_queue == Null)
+            {
+                Dispatch(level, bpf::String::Format(format, ToLogArg(args)...));
+                return;
+            }
+            Record record;
+            record.Set(level, format, args...);
+            Push(record);
+        }
+
+    public:
+        /**
+         * Constructs a new AsyncLogger
+         * @param category the category passed to the handlers
+         */
+        explicit AsyncLogger(const bpf::String &category);
+
+        /**
+         * Dispatches all queued messages then stops the background thread
+         */
+        ~AsyncLogger();
+
+        AsyncLogger(const AsyncLogger &other) = delete;
+        AsyncLogger &operator=(const AsyncLogger &other) = delete;
+
+        void AddHandler(bpf::memory::UniquePtr<bpf::log::ILogAdapter> &&ptr);
+
+        /**
+         * Starts the background thread, messages are then queued instead of being formatted by the caller
+         * Calling this function again has no effect
+         * @param capacity the capacity of the ring buffer, callers wait for the background thread when it is full
+         */
+        void EnableAsync(bpf::fsize capacity = 4096);
+
+        inline bool IsAsync() const noexcept
+        {
+            return (_queue != Null);
+        }
+
+        /**
+         * Blocks until all queued messages have been dispatched to the handlers
+         */
+        void Flush();
+
+        template <typename... Args>
+        inline void Debug(const char *format, const Args &...args)
+        {
+            if constexpr (BP3D_MIN_LOG_LEVEL <= 0)
+                Log(bpf::log::ELogLevel::DEBUG, format, args...);
+        }
+
+        template <typename... Args>
+        inline void Info(const char *format, const Args &...args)
+        {
+            if constexpr (BP3D_MIN_LOG_LEVEL <= 1)
+                Log(bpf::log::ELogLevel::INFO, format, args...);
+        }
+
+        template <typename... Args>
+        inline void Warning(const char *format, const Args &...args)
+        {
+            if constexpr (BP3D_MIN_LOG_LEVEL <= 2)
+                Log(bpf::log::ELogLevel::WARNING, format, args...);
+        }
+
+        template <typename... Args>
+        inline void Error(const char *format, const Args &...args)
+        {
+            if constexpr (BP3D_MIN_LOG_LEVEL <= 3)
+                Log(bpf::log::ELogLevel::ERROR, format, args...);
+        }
+    };
+}
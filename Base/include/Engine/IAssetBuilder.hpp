@@ -30,8 +30,11 @@
 #include <Framework/String.hpp>
 #include <Framework/Tuple.hpp>
 #include <Framework/Collection/List.hpp>
+#include <Framework/Collection/ArrayList.hpp>
+#include <Framework/IO/ByteBuf.hpp>
 #include <Framework/Memory/UniquePtr.hpp>
 #include "Engine/Asset.hpp"
+#include "Engine/CancellationToken.hpp"
 
 namespace bp3d
 {
@@ -48,8 +51,91 @@ namespace bp3d
          * This function may not be called on the main thread so beware of race conditions
          * It is unsafe to call any rendering method or driver resource allocations in this function
          * This method typically runs file IO and pre-calculations in order to prepare the data for the Mount method
+         * @param token set when the asset is removed before being mounted, long builds should check it and return early
          */
-        virtual void Build() = 0;
+        virtual void Build(const CancellationToken &token) = 0;
+
+        /**
+         * Returns true if this builder separates file IO from computation
+         * Staged builders are first handed to the IO workers through Read and then to the compute workers through Compute, Build is not called
+         */
+        virtual bool IsStaged() const noexcept
+        {
+            return (false);
+        }
+
+        /**
+         * IO stage of a staged builder, should only read source data
+         * @param token set when the asset is removed before being mounted
+         * @param buffers output list of buffers handed over to Compute
+         */
+        virtual void Read(const CancellationToken & /*token*/, bpf::collection::ArrayList<bpf::io::ByteBuf> & /*buffers*/)
+        {
+        }
+
+        /**
+         * Compute stage of a staged builder, decodes and pre-calculates from the buffers produced by Read
+         * @param token set when the asset is removed before being mounted
+         * @param buffers the buffers produced by Read, released once this method returns
+         */
+        virtual void Compute(const CancellationToken & /*token*/, bpf::collection::ArrayList<bpf::io::ByteBuf> & /*buffers*/)
+        {
+        }
+
+        /**
+         * Returns the version of the data serialized by this builder, 0 if this builder does not support the build cache
+         * Bump the version whenever the output of Serialize changes so that stale blobs are ignored
+         */
+        virtual bpf::uint32 GetCacheVersion() const noexcept
+        {
+            return (0);
+        }
+
+        /**
+         * Serializes the built state of this builder into a cache blob, called on a worker after a successfull build
+         */
+        virtual bpf::io::ByteBuf Serialize() const
+        {
+            return (bpf::io::ByteBuf(0));
+        }
+
+        /**
+         * Restores the built state of this builder from a cache blob, called on a worker instead of building
+         * @param blob the blob produced by Serialize for the same source file content and cache version
+         * @return false if the blob is unusable, the asset is then built as usual
+         */
+        virtual bool Deserialize(bpf::io::ByteBuf & /*blob*/)
+        {
+            return (false);
+        }
+
+        /**
+         * Returns true if a finer version of the mounted asset can still be streamed in
+         * Progressive builders build and mount a coarse version first (low mips, low LOD...),
+         * then Refine and Apply are called in turn for as long as this function returns true
+         */
+        virtual bool HasRefinement() const noexcept
+        {
+            return (false);
+        }
+
+        /**
+         * Streams and prepares the next refinement of the mounted asset, runs on a compute worker like Build
+         * @param token set when the asset is removed
+         */
+        virtual void Refine(const CancellationToken & /*token*/)
+        {
+        }
+
+        /**
+         * Callback after a successfull call to Refine on the main thread, updates the mounted asset in place
+         * The asset object is never replaced so that pointers and handles held by callers stay valid
+         * @param assets The instance of the AssetManager responsible for this IAssetBuilder
+         * @param asset The asset returned by Mount
+         */
+        virtual void Apply(AssetManager & /*assets*/, Asset & /*asset*/)
+        {
+        }
 
         /**
          * Returns a list of assets to be loaded as a result of the expansion of this asset
@@ -0,0 +1,161 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#pragma once
+#include <atomic>
+#include <Framework/Types.hpp>
+
+namespace bp3d
+{
+    /**
+     * Bounded lock-free multi-producer multi-consumer FIFO queue
+     * The capacity is rounded up to the next power of two
+     * Neither TryPush nor TryPop ever block, they fail instead when the queue is full or empty
+     */
+    template <typename T>
+    class RingQueue
+    {
+    private:
+        struct Cell
+        {
+            std::atomic<bpf::fsize> Sequence;
+            T Data;
+        };
+
+        Cell *_cells;
+        bpf::fsize _mask;
+        alignas(64) std::atomic<bpf::fsize> _enqueuePos;
+        alignas(64) std::atomic<bpf::fsize> _dequeuePos;
+
+        static bpf::fsize RoundCapacity(bpf::fsize capacity) noexcept
+        {
+            bpf::fsize res = 2;
+
+            while (res < capacity)
+                res <<= 1;
+            return (res);
+        }
+
+    public:
+        explicit RingQueue(const bpf::fsize capacity)
+            : _cells(nullptr)
+            , _mask(RoundCapacity(capacity) - 1)
+            , _enqueuePos(0)
+            , _dequeuePos(0)
+        {
+            _cells = new Cell[_mask + 1];
+            for (bpf::fsize i = 0; i <= _mask; ++i)
+                _cells[i].Sequence.store(i, std::memory_order_relaxed);
+        }
+
+        ~RingQueue()
+        {
+            delete[] _cells;
+        }
+
+        RingQueue(const RingQueue &other) = delete;
+        RingQueue &operator=(const RingQueue &other) = delete;
+
+        /**
+         * Attempts to push a new value at the end of the queue
+         * @param value the value to push, only moved from if the push succeeds
+         * @return false if the queue is full
+         */
+        bool TryPush(T &value)
+        {
+            bpf::fsize pos = _enqueuePos.load(std::memory_order_relaxed);
+            Cell *cell;
+
+            for (;;)
+            {
+                cell = &_cells[pos & _mask];
+                bpf::fsize seq = cell->Sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<bpf::fisize>(seq) - static_cast<bpf::fisize>(pos);
+                if (diff == 0)
+                {
+                    if (_enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return (false);
+                else
+                    pos = _enqueuePos.load(std::memory_order_relaxed);
+            }
+            cell->Data = std::move(value);
+            cell->Sequence.store(pos + 1, std::memory_order_release);
+            return (true);
+        }
+
+        /**
+         * Attempts to pop the first value of the queue
+         * @param value output value
+         * @return false if the queue is empty
+         */
+        bool TryPop(T &value)
+        {
+            bpf::fsize pos = _dequeuePos.load(std::memory_order_relaxed);
+            Cell *cell;
+
+            for (;;)
+            {
+                cell = &_cells[pos & _mask];
+                bpf::fsize seq = cell->Sequence.load(std::memory_order_acquire);
+                auto diff = static_cast<bpf::fisize>(seq) - static_cast<bpf::fisize>(pos + 1);
+                if (diff == 0)
+                {
+                    if (_dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                        break;
+                }
+                else if (diff < 0)
+                    return (false);
+                else
+                    pos = _dequeuePos.load(std::memory_order_relaxed);
+            }
+            value = std::move(cell->Data);
+            cell->Sequence.store(pos + _mask + 1, std::memory_order_release);
+            return (true);
+        }
+
+        /**
+         * Returns the number of values in the queue
+         * The result is only a snapshot when other threads are pushing or popping concurrently
+         */
+        inline bpf::fsize GetSizeApprox() const noexcept
+        {
+            bpf::fsize enq = _enqueuePos.load(std::memory_order_acquire);
+            bpf::fsize deq = _dequeuePos.load(std::memory_order_acquire);
+
+            return (enq > deq ? enq - deq : 0);
+        }
+
+        inline bpf::fsize GetCapacity() const noexcept
+        {
+            return (_mask + 1);
+        }
+    };
+}
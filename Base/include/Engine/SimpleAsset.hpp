@@ -39,7 +39,7 @@ namespace bp3d
 
     public:
         virtual ~SimpleAsset() {}
-        virtual void Build() = 0;
+        virtual void Build(const CancellationToken &token) = 0;
         virtual bpf::memory::UniquePtr<Asset> Mount(AssetManager &assets, const bpf::String &vpath) = 0;
 
         inline const bpf::collection::List<bpf::Tuple<bpf::String, bpf::String>> &GetExpandedAssets() const noexcept final
@@ -0,0 +1,150 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Framework/IO/FileStream.hpp>
+#include "Engine/AssetBuildCache.hpp"
+
+using namespace bp3d;
+
+//FNV-1a 64 bits
+constexpr bpf::uint64 HASH_OFFSET = 0xCBF29CE484222325;
+constexpr bpf::uint64 HASH_PRIME = 0x100000001B3;
+
+//Blob header: magic followed by the payload size
+constexpr bpf::uint32 BLOB_MAGIC = 0x43415042; //BPAC
+constexpr bpf::fsize BLOB_HEADER_SIZE = sizeof(bpf::uint32) + sizeof(bpf::uint64);
+
+static bpf::uint64 HashBytes(bpf::uint64 hash, const bpf::uint8 *data, bpf::fsize size)
+{
+    for (bpf::fsize i = 0; i != size; ++i)
+    {
+        hash ^= data[i];
+        hash *= HASH_PRIME;
+    }
+    return (hash);
+}
+
+static bpf::String ToHex(bpf::uint64 value)
+{
+    constexpr const char *DIGITS = "0123456789abcdef";
+    bpf::String str;
+
+    for (int shift = 60; shift >= 0; shift -= 4)
+        str += DIGITS[(value >> shift) & 0xF];
+    return (str);
+}
+
+AssetBuildCache::AssetBuildCache(const bpf::system::Paths &paths)
+    : _paths(paths)
+    , _directory(paths.CacheDir + "Assets")
+{
+}
+
+bool AssetBuildCache::Initialize()
+{
+    if (!_paths.CacheDir.Exists())
+        _paths.CacheDir.CreateDir();
+    if (!_directory.Exists())
+        _directory.CreateDir();
+    return (_directory.Exists());
+}
+
+bool AssetBuildCache::HashFile(const bpf::io::File &file, bpf::uint64 &hash)
+{
+    bpf::uint8 buf[8192];
+
+    try
+    {
+        bpf::io::FileStream stream(file, bpf::io::FILE_MODE_READ);
+        bpf::fsize len;
+        hash = HASH_OFFSET;
+        while ((len = stream.Read(buf, sizeof(buf))) > 0)
+            hash = HashBytes(hash, buf, len);
+        return (true);
+    }
+    catch (const bpf::io::IOException &)
+    {
+        return (false);
+    }
+}
+
+bpf::io::File AssetBuildCache::GetBlobPath(const bpf::String &format, bpf::uint64 sourceHash, bpf::uint32 version) const
+{
+    auto formatHash = HashBytes(HASH_OFFSET, reinterpret_cast<const bpf::uint8 *>(*format), format.Size());
+
+    return (_directory + bpf::String::Format("[]-[]-[].bin", ToHex(formatHash), ToHex(sourceHash), version));
+}
+
+bool AssetBuildCache::Load(const bpf::String &format, const bpf::io::File &source, IAssetBuilder &builder, bpf::io::File &blob) const
+{
+    bpf::uint64 sourceHash;
+
+    blob = bpf::io::File();
+    if (!HashFile(source, sourceHash))
+        return (false);
+    blob = GetBlobPath(format, sourceHash, builder.GetCacheVersion());
+    auto size = blob.GetSizeBytes();
+    if (size < BLOB_HEADER_SIZE)
+        return (false);
+    try
+    {
+        bpf::io::FileStream stream(blob, bpf::io::FILE_MODE_READ);
+        bpf::uint32 magic;
+        bpf::uint64 payloadSize;
+        if (stream.Read(&magic, sizeof(magic)) != sizeof(magic) || magic != BLOB_MAGIC
+            || stream.Read(&payloadSize, sizeof(payloadSize)) != sizeof(payloadSize)
+            || payloadSize != size - BLOB_HEADER_SIZE)
+            return (false); //Corrupted or partially written blob
+        bpf::io::ByteBuf payload(static_cast<bpf::fsize>(payloadSize));
+        if (stream.Read(*payload, payload.Size()) != payload.Size())
+            return (false);
+        return (builder.Deserialize(payload));
+    }
+    catch (const bpf::RuntimeException &)
+    {
+        //A blob which can not be read or restored is rebuilt and overwritten
+        return (false);
+    }
+}
+
+void AssetBuildCache::Store(const IAssetBuilder &builder, const bpf::io::File &blob) const
+{
+    try
+    {
+        auto payload = builder.Serialize();
+        bpf::uint64 payloadSize = payload.Size();
+        bpf::io::FileStream stream(blob, bpf::io::FILE_MODE_WRITE | bpf::io::FILE_MODE_TRUNCATE);
+        stream.Write(&BLOB_MAGIC, sizeof(BLOB_MAGIC));
+        stream.Write(&payloadSize, sizeof(payloadSize));
+        stream.Write(*payload, payload.Size());
+    }
+    catch (const bpf::RuntimeException &)
+    {
+        //The asset is simply built again on the next load
+    }
+}
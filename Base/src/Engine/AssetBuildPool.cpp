@@ -0,0 +1,466 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <thread>
+#include <Framework/Memory/MemUtils.hpp>
+#include <Framework/System/ScopeLock.hpp>
+#include "Engine/AssetBuildPool.hpp"
+
+using namespace bp3d;
+
+//Job states, a queued job holds the index of the stage it waits for
+constexpr int JOB_CLAIMED = -1;
+
+AssetBuildPool::AssetBuildPool(bpf::fsize workers, bpf::fsize ioWorkers, bpf::fsize capacity)
+    : _building(0)
+    , _mainWaiting(false)
+    , _exit(false)
+    , _tracer(Null)
+{
+    for (bpf::fsize p = 0; p != ASSET_PRIORITY_COUNT; ++p)
+    {
+        for (bpf::fsize s = 0; s != BUILD_STAGE_COUNT; ++s)
+            _pendingJobs[s][p] = bpf::memory::MakeUnique<JobQueue>(capacity);
+        _mountableJobs[p] = bpf::memory::MakeUnique<JobQueue>(capacity);
+    }
+    for (bpf::fsize s = 0; s != BUILD_STAGE_COUNT; ++s)
+        _sleepingWorkers[s] = 0;
+    StartWorkers(EBuildStage::COMPUTE, workers == 0 ? GetDefaultWorkerCount() : workers);
+    StartWorkers(EBuildStage::IO, ioWorkers == 0 ? GetDefaultIOWorkerCount() : ioWorkers);
+}
+
+AssetBuildPool::~AssetBuildPool()
+{
+    //Let long builds return early
+    for (auto &entry : _queuedJobs)
+        entry.Value->Token.Cancel();
+    _mutex.Lock();
+    _exit = true;
+    for (bpf::fsize s = 0; s != BUILD_STAGE_COUNT; ++s)
+        _pendingCond[s].NotifyAll();
+    _mutex.Unlock();
+    for (auto &worker : _workers)
+        worker->Join();
+    //Drop every remaining reference now that no worker can touch the queues anymore
+    Job *job;
+    for (bpf::fsize p = 0; p != ASSET_PRIORITY_COUNT; ++p)
+    {
+        for (bpf::fsize s = 0; s != BUILD_STAGE_COUNT; ++s)
+        {
+            while (_pendingJobs[s][p]->TryPop(job))
+                Release(job);
+            while (_overflow[s][p].Size() > 0)
+                Release(_overflow[s][p].Pop());
+        }
+        while (_mountableJobs[p]->TryPop(job))
+            Release(job);
+    }
+    for (auto &entry : _queuedJobs)
+        Release(entry.Value);
+}
+
+void AssetBuildPool::StartWorkers(EBuildStage stage, bpf::fsize count)
+{
+    _workerCount[static_cast<bpf::fsize>(stage)] = count;
+    for (bpf::fsize i = 0; i != count; ++i)
+    {
+        _workers.Add(bpf::memory::MakeUnique<AssetBuildThread>(*this, stage, i));
+        _workers.Last()->Start();
+    }
+}
+
+bpf::fsize AssetBuildPool::GetDefaultWorkerCount() noexcept
+{
+    bpf::fsize count = std::thread::hardware_concurrency();
+
+    if (count == 0) //The platform is unable to report its hardware concurrency
+        return (1);
+    return (count);
+}
+
+bpf::fsize AssetBuildPool::GetDefaultIOWorkerCount() noexcept
+{
+    return (2);
+}
+
+void AssetBuildPool::Release(Job *job)
+{
+    if (job->Refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        bpf::memory::MemUtils::Delete(job);
+}
+
+void AssetBuildPool::AbandonJob(Job *job)
+{
+    _building.fetch_sub(1, std::memory_order_release);
+    Release(job);
+}
+
+void AssetBuildPool::ReleaseOwnership(Job *job)
+{
+    auto name = bpf::Name(job->VPath);
+
+    if (_queuedJobs.HasKey(name) && _queuedJobs[name] == job)
+    {
+        _queuedJobs.RemoveAt(name);
+        Release(job);
+    }
+}
+
+void AssetBuildPool::PushPendingJob(Job *job, EBuildStage stage, EAssetPriority priority)
+{
+    auto s = static_cast<bpf::fsize>(stage);
+    auto p = static_cast<bpf::fsize>(priority);
+
+    if (_overflow[s][p].Size() > 0 || !_pendingJobs[s][p]->TryPush(job))
+        _overflow[s][p].Push(job);
+}
+
+bool AssetBuildPool::PopPendingJob(EBuildStage stage, Job *&job)
+{
+    auto s = static_cast<bpf::fsize>(stage);
+
+    for (bpf::fsize p = ASSET_PRIORITY_COUNT; p-- > 0;)
+    {
+        while (_pendingJobs[s][p]->TryPop(job))
+        {
+            int expected = static_cast<int>(stage);
+            if (job->State.compare_exchange_strong(expected, JOB_CLAIMED, std::memory_order_acq_rel))
+                return (true);
+            Release(job); //Stale reference left behind by SetPriority or Cancel
+        }
+    }
+    return (false);
+}
+
+bool AssetBuildPool::HasOverflow() const noexcept
+{
+    for (bpf::fsize s = 0; s != BUILD_STAGE_COUNT; ++s)
+    {
+        for (bpf::fsize p = 0; p != ASSET_PRIORITY_COUNT; ++p)
+        {
+            if (_overflow[s][p].Size() > 0)
+                return (true);
+        }
+    }
+    return (false);
+}
+
+void AssetBuildPool::FlushOverflow()
+{
+    for (bpf::fsize s = 0; s != BUILD_STAGE_COUNT; ++s)
+    {
+        for (bpf::fsize p = 0; p != ASSET_PRIORITY_COUNT; ++p)
+        {
+            while (_overflow[s][p].Size() > 0)
+            {
+                if (!_pendingJobs[s][p]->TryPush(_overflow[s][p].Top()))
+                    break;
+                _overflow[s][p].Pop();
+            }
+        }
+    }
+}
+
+void AssetBuildPool::WakeWorkers(EBuildStage stage, bool all)
+{
+    auto s = static_cast<bpf::fsize>(stage);
+
+    //Pairs with the fence in WaitPendingEntry: either the worker sees the new job or we see the sleeping worker
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleepingWorkers[s].load(std::memory_order_relaxed) > 0)
+    {
+        auto lock = bpf::system::ScopeLock(_mutex);
+        if (all)
+            _pendingCond[s].NotifyAll();
+        else
+            _pendingCond[s].NotifyOne();
+    }
+}
+
+void AssetBuildPool::WakeAllWorkers()
+{
+    WakeWorkers(EBuildStage::IO, true);
+    WakeWorkers(EBuildStage::COMPUTE, true);
+}
+
+void AssetBuildPool::Enqueue(Entry &&entry)
+{
+    auto name = bpf::Name(entry.VPath);
+    auto job = bpf::memory::MemUtils::New<Job>();
+    auto stage = GetFirstStage(entry);
+
+    job->VPath = std::move(entry.VPath);
+    job->Builder = std::move(entry.Builder);
+    job->Priority = entry.Priority;
+    job->Format = std::move(entry.Format);
+    job->Source = std::move(entry.Source);
+    job->ReadyMicros = AssetTimings::Now();
+    job->RefineSerial = entry.RefineSerial;
+    job->SlotIndex = entry.SlotIndex;
+    job->SlotGeneration = entry.SlotGeneration;
+    job->State = static_cast<int>(stage);
+    job->CurPriority = static_cast<int>(entry.Priority);
+    job->Refs = 2; //One for _queuedJobs, one for the pending queue
+    if (_queuedJobs.HasKey(name))
+        Release(_queuedJobs[name]);
+    _queuedJobs[name] = job;
+    _building.fetch_add(1, std::memory_order_relaxed);
+    PushPendingJob(job, stage, entry.Priority);
+}
+
+EBuildStage AssetBuildPool::GetFirstStage(const Entry &entry) noexcept
+{
+    if (entry.RefineSerial != 0 || !entry.Builder->IsStaged())
+        return (EBuildStage::COMPUTE);
+    return (EBuildStage::IO);
+}
+
+void AssetBuildPool::Add(const bpf::String &vpath, bpf::memory::UniquePtr<IAssetBuilder> &&ptr, EAssetPriority priority)
+{
+    Entry entry;
+
+    entry.VPath = vpath;
+    entry.Builder = std::move(ptr);
+    entry.Priority = priority;
+    Add(std::move(entry));
+}
+
+void AssetBuildPool::Add(Entry &&entry)
+{
+    auto stage = GetFirstStage(entry);
+
+    FlushOverflow();
+    Enqueue(std::move(entry));
+    WakeWorkers(stage, false);
+}
+
+void AssetBuildPool::AddBatch(bpf::collection::ArrayList<Entry> &entries)
+{
+    FlushOverflow();
+    for (auto &entry : entries)
+        Enqueue(std::move(entry));
+    entries.Clear();
+    WakeAllWorkers();
+}
+
+bool AssetBuildPool::SetPriority(const bpf::Name &vpath, EAssetPriority priority)
+{
+    if (!_queuedJobs.HasKey(vpath))
+        return (false);
+    Job *job = _queuedJobs[vpath];
+    int state = job->State.load(std::memory_order_acquire);
+    if (state == JOB_CLAIMED)
+        return (false);
+    if (job->CurPriority.load(std::memory_order_relaxed) == static_cast<int>(priority))
+        return (true);
+    //If the job moves to another stage meanwhile, the stale reference fails to claim it and is dropped
+    auto stage = static_cast<EBuildStage>(state);
+    job->CurPriority.store(static_cast<int>(priority), std::memory_order_relaxed);
+    job->Refs.fetch_add(1, std::memory_order_relaxed);
+    PushPendingJob(job, stage, priority);
+    WakeWorkers(stage, false);
+    return (true);
+}
+
+bool AssetBuildPool::Cancel(const bpf::Name &vpath)
+{
+    if (!_queuedJobs.HasKey(vpath))
+        return (false);
+    Job *job = _queuedJobs[vpath];
+    job->Token.Cancel();
+    //Claiming the job ourselves makes workers drop it; the queue references are released as they are popped
+    int expected = job->State.load(std::memory_order_acquire);
+    while (expected != JOB_CLAIMED)
+    {
+        if (job->State.compare_exchange_weak(expected, JOB_CLAIMED, std::memory_order_acq_rel))
+        {
+            _building.fetch_sub(1, std::memory_order_release);
+            break;
+        }
+    }
+    ReleaseOwnership(job);
+    return (true);
+}
+
+bool AssetBuildPool::SetTracer(bpf::memory::UniquePtr<AssetTracer> &&tracer)
+{
+    if (_tracerPtr != Null)
+        return (false);
+    _tracerPtr = std::move(tracer);
+    _tracer.store(_tracerPtr.Raw(), std::memory_order_release);
+    return (true);
+}
+
+const CancellationToken &AssetBuildPool::GetCancellationToken(const Entry *entry) noexcept
+{
+    return (static_cast<const Job *>(entry)->Token);
+}
+
+bpf::collection::ArrayList<bpf::io::ByteBuf> &AssetBuildPool::GetBuffers(Entry *entry) noexcept
+{
+    return (static_cast<Job *>(entry)->Buffers);
+}
+
+bool AssetBuildPool::PollMountableEntry(Entry &entry)
+{
+    if (HasOverflow())
+    {
+        FlushOverflow();
+        WakeAllWorkers();
+    }
+    Job *job;
+    for (bpf::fsize p = ASSET_PRIORITY_COUNT; p-- > 0;)
+    {
+        while (_mountableJobs[p]->TryPop(job))
+        {
+            ReleaseOwnership(job);
+            if (job->Token.IsCancelled())
+            {
+                Release(job);
+                continue;
+            }
+            entry.VPath = std::move(job->VPath);
+            entry.Builder = std::move(job->Builder);
+            entry.Error = std::move(job->Error);
+            entry.Timings = job->Timings;
+            entry.ReadyMicros = job->ReadyMicros;
+            entry.RefineSerial = job->RefineSerial;
+            entry.SlotIndex = job->SlotIndex;
+            entry.SlotGeneration = job->SlotGeneration;
+            entry.Priority = static_cast<EAssetPriority>(job->CurPriority.load(std::memory_order_relaxed));
+            Release(job);
+            return (true);
+        }
+    }
+    return (false);
+}
+
+bool AssetBuildPool::WaitPendingEntry(EBuildStage stage, Entry *&entry)
+{
+    auto s = static_cast<bpf::fsize>(stage);
+    Job *job;
+
+    while (!_exit.load(std::memory_order_relaxed))
+    {
+        if (PopPendingJob(stage, job))
+        {
+            entry = job;
+            return (true);
+        }
+        auto lock = bpf::system::ScopeLock(_mutex);
+        _sleepingWorkers[s].fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (PopPendingJob(stage, job))
+        {
+            _sleepingWorkers[s].fetch_sub(1, std::memory_order_relaxed);
+            entry = job;
+            return (true);
+        }
+        if (!_exit)
+            _pendingCond[s].Wait(_mutex);
+        _sleepingWorkers[s].fetch_sub(1, std::memory_order_relaxed);
+    }
+    return (false);
+}
+
+void AssetBuildPool::PushComputeEntry(Entry *entry)
+{
+    Job *job = static_cast<Job *>(entry);
+    auto p = static_cast<bpf::fsize>(job->CurPriority.load(std::memory_order_relaxed));
+    auto &queue = _pendingJobs[static_cast<bpf::fsize>(EBuildStage::COMPUTE)][p];
+
+    //Re-opens the job for claiming, this time by the compute workers; the reference held by the IO queue moves to the compute queue
+    job->State.store(static_cast<int>(EBuildStage::COMPUTE), std::memory_order_release);
+    //Only the main thread may use the overflow queues; wait for the compute workers to make room if the queue is full
+    while (!queue->TryPush(job))
+    {
+        if (_exit.load(std::memory_order_relaxed))
+        {
+            AbandonJob(job); //The compute workers are leaving, nobody will make room anymore
+            return;
+        }
+        bpf::system::Thread::Sleep(1);
+    }
+    WakeWorkers(EBuildStage::COMPUTE, false);
+}
+
+void AssetBuildPool::PushMountableEntry(Entry *entry)
+{
+    Job *job = static_cast<Job *>(entry);
+    auto p = static_cast<bpf::fsize>(job->CurPriority.load(std::memory_order_relaxed));
+
+    //The main thread is the only consumer; wait for it to make room if the queue is full
+    while (!_mountableJobs[p]->TryPush(job))
+    {
+        if (_exit.load(std::memory_order_relaxed))
+        {
+            AbandonJob(job); //The pool is being destroyed, the main thread will not poll anymore
+            return;
+        }
+        bpf::system::Thread::Sleep(1);
+    }
+    _building.fetch_sub(1, std::memory_order_release);
+    //Pairs with the fence in WaitMountableEntries
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_mainWaiting.load(std::memory_order_relaxed))
+    {
+        auto lock = bpf::system::ScopeLock(_mutex);
+        _mountableCond.NotifyAll();
+    }
+}
+
+bpf::fsize AssetBuildPool::GetMountableCount() const noexcept
+{
+    bpf::fsize count = 0;
+
+    for (bpf::fsize p = 0; p != ASSET_PRIORITY_COUNT; ++p)
+        count += _mountableJobs[p]->GetSizeApprox();
+    return (count);
+}
+
+bool AssetBuildPool::HasPendingWork() const noexcept
+{
+    return (_building.load(std::memory_order_acquire) != 0 || GetMountableCount() != 0);
+}
+
+bpf::fsize AssetBuildPool::GetPendingCount() const noexcept
+{
+    return (_building.load(std::memory_order_acquire) + GetMountableCount());
+}
+
+void AssetBuildPool::WaitMountableEntries()
+{
+    FlushOverflow();
+    WakeAllWorkers();
+    auto lock = bpf::system::ScopeLock(_mutex);
+    _mainWaiting = true;
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while (GetMountableCount() == 0 && _building.load(std::memory_order_acquire) != 0)
+        _mountableCond.Wait(_mutex);
+    _mainWaiting = false;
+}
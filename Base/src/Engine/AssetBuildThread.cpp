@@ -26,60 +26,83 @@
 // NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
-#include <Framework/System/ScopeLock.hpp>
 #include "Engine/AssetBuildThread.hpp"
+#include "Engine/AssetBuildPool.hpp"
 
 using namespace bp3d;
 
-AssetBuildThread::AssetBuildThread()
-    : bpf::system::Thread("AssetBuilder")
+static const char *GetSpanName(const EBuildStage stage, const AssetBuildPool::Entry &entry, const bool cached)
 {
+    if (entry.RefineSerial != 0)
+        return ("Refine");
+    if (cached)
+        return ("Cache");
+    if (stage == EBuildStage::IO)
+        return ("Read");
+    return (entry.Builder->IsStaged() ? "Compute" : "Build");
 }
 
-void AssetBuildThread::Add(const bpf::String &vpath, bpf::memory::UniquePtr<IAssetBuilder> &&ptr)
+AssetBuildThread::AssetBuildThread(AssetBuildPool &pool, const EBuildStage stage, const bpf::fsize id)
+    : bpf::system::Thread(bpf::String::Format(stage == EBuildStage::IO ? "AssetReader#[]" : "AssetBuilder#[]", id))
+    , _pool(pool)
+    , _stage(stage)
 {
-    auto lock = bpf::system::ScopeLock(_mutex);
-    Entry entry;
-    entry.VPath = vpath;
-    entry.Builder = std::move(ptr);
-    _pendingEntries.Push(std::move(entry));
-}
-
-bool AssetBuildThread::PollMountableEntry(Entry &entry)
-{
-    auto lock = bpf::system::ScopeLock(_mutex);
-    if (_mountableEntries.Size() == 0)
-        return (false);
-    entry = _mountableEntries.Pop();
-    return (true);
 }
 
 void AssetBuildThread::Run()
 {
-    _mutex.Lock();
-    bpf::fsize size = _pendingEntries.Size();
-    _mutex.Unlock();
+    AssetBuildPool::Entry *entry;
 
-    while (size > 0)
+    //Sleeps inside WaitPendingEntry until an entry is queued or the pool is shutting down
+    while (_pool.WaitPendingEntry(_stage, entry))
     {
-        _mutex.Lock();
-        Entry entry = _pendingEntries.Pop();
-        _mutex.Unlock();
+        const auto &token = AssetBuildPool::GetCancellationToken(entry);
+        auto &buffers = AssetBuildPool::GetBuffers(entry);
+        bool refining = entry->RefineSerial != 0;
+        AssetBuildCache *cache = entry->Source.Path() == bpf::String::Empty || refining ? Null : _pool.GetBuildCache();
+        bool cached = false;
+        auto start = AssetTimings::Now();
+        entry->Timings.QueueWaitMicros += start - entry->ReadyMicros;
         try
         {
-            entry.Builder->Build();
-            entry.Error = bpf::String::Empty;
-            _mutex.Lock();
-            _mountableEntries.Push(std::move(entry));
-            _mutex.Unlock();
+            //Cancelled entries go straight to the main thread which drops them
+            if (!token.IsCancelled())
+            {
+                //The cache is looked up by the first stage of the entry and filled by the last one
+                if (cache != Null && (_stage == EBuildStage::IO || !entry->Builder->IsStaged()))
+                    cached = cache->Load(entry->Format, entry->Source, *entry->Builder, entry->CacheBlob);
+                if (!cached)
+                {
+                    if (refining)
+                        entry->Builder->Refine(token);
+                    else if (_stage == EBuildStage::IO)
+                        entry->Builder->Read(token, buffers);
+                    else if (entry->Builder->IsStaged())
+                        entry->Builder->Compute(token, buffers);
+                    else
+                        entry->Builder->Build(token);
+                    if (cache != Null && _stage == EBuildStage::COMPUTE && !token.IsCancelled()
+                        && entry->CacheBlob.Path() != bpf::String::Empty)
+                        cache->Store(*entry->Builder, entry->CacheBlob);
+                }
+            }
+            entry->Error = bpf::String::Empty;
         }
         catch (const bpf::RuntimeException &ex)
         {
-            entry.Error = bpf::String::Format("[]: []", ex.Type(), ex.Message());
-            _mutex.Lock();
-            _mountableEntries.Push(std::move(entry));
-            _mutex.Unlock();
+            entry->Error = bpf::String::Format("[]: []", ex.Type(), ex.Message());
+        }
+        entry->ReadyMicros = AssetTimings::Now();
+        entry->Timings.BuildMicros += entry->ReadyMicros - start;
+        AssetTracer *tracer = _pool.GetTracer();
+        if (tracer != Null)
+            tracer->Span(GetSpanName(_stage, *entry, cached), entry->VPath, start, entry->ReadyMicros);
+        if (_stage == EBuildStage::IO && !cached && entry->Error == bpf::String::Empty && !token.IsCancelled())
+            _pool.PushComputeEntry(entry);
+        else
+        {
+            buffers.Clear();
+            _pool.PushMountableEntry(entry);
         }
-        --size;
     }
 }
@@ -0,0 +1,240 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef WINDOWS
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+#include <Framework/Memory/MemUtils.hpp>
+#include <Framework/System/ScopeLock.hpp>
+#include "Engine/AssetFileView.hpp"
+#include "Engine/AssetUrl.hpp"
+
+using namespace bp3d;
+
+AssetFileView &AssetFileView::operator=(const AssetFileView &other) noexcept
+{
+    if (this == &other)
+        return (*this);
+    if (other._mapping != Null)
+        other._mapping->Refs.fetch_add(1, std::memory_order_relaxed);
+    Release();
+    _mapping = other._mapping;
+    return (*this);
+}
+
+AssetFileView &AssetFileView::operator=(AssetFileView &&other) noexcept
+{
+    if (this == &other)
+        return (*this);
+    Release();
+    _mapping = other._mapping;
+    other._mapping = Null;
+    return (*this);
+}
+
+void AssetFileView::Release()
+{
+    if (_mapping == Null)
+        return;
+    auto refs = _mapping->Refs.load(std::memory_order_relaxed);
+    //Only the owner may drop the last reference: it is also the only one able to hand out a new reference to a mapping
+    while (refs > 1)
+    {
+        if (_mapping->Refs.compare_exchange_weak(refs, refs - 1, std::memory_order_release, std::memory_order_relaxed))
+        {
+            _mapping = Null;
+            return;
+        }
+    }
+    _mapping->Owner->Release(_mapping);
+    _mapping = Null;
+}
+
+#ifdef WINDOWS
+AssetFileView::Mapping *AssetFileMapper::Map(const bpf::String &path, AssetFileView::Mapping *current)
+{
+    HANDLE file = CreateFileA(*path, GENERIC_READ, FILE_SHARE_READ, Null, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, Null);
+    BY_HANDLE_FILE_INFORMATION info;
+    AssetFileView::FileIdentity identity;
+
+    if (file == INVALID_HANDLE_VALUE)
+        return (Null);
+    if (!GetFileInformationByHandle(file, &info))
+    {
+        CloseHandle(file);
+        return (Null);
+    }
+    identity.Device = info.dwVolumeSerialNumber;
+    identity.Inode = (static_cast<bpf::uint64>(info.nFileIndexHigh) << 32) | info.nFileIndexLow;
+    identity.Size = (static_cast<bpf::uint64>(info.nFileSizeHigh) << 32) | info.nFileSizeLow;
+    identity.ModifiedTime = static_cast<bpf::int64>((static_cast<bpf::uint64>(info.ftLastWriteTime.dwHighDateTime) << 32) | info.ftLastWriteTime.dwLowDateTime);
+    if (current != Null && current->Identity == identity)
+    {
+        CloseHandle(file);
+        return (current);
+    }
+    auto mapping = bpf::memory::MemUtils::New<AssetFileView::Mapping>();
+    mapping->Identity = identity;
+    mapping->Size = static_cast<bpf::fsize>(identity.Size);
+    mapping->Data = Null;
+    if (mapping->Size > 0)
+    {
+        HANDLE section = CreateFileMappingA(file, Null, PAGE_READONLY, 0, 0, Null);
+        if (section != Null)
+        {
+            mapping->Data = static_cast<const bpf::uint8 *>(MapViewOfFile(section, FILE_MAP_READ, 0, 0, 0));
+            CloseHandle(section); //The view keeps the section alive
+        }
+    }
+    CloseHandle(file);
+    if (mapping->Size > 0 && mapping->Data == Null)
+    {
+        bpf::memory::MemUtils::Delete(mapping);
+        return (Null);
+    }
+    return (mapping);
+}
+
+void AssetFileMapper::Unmap(AssetFileView::Mapping &mapping)
+{
+    if (mapping.Data != Null)
+        UnmapViewOfFile(mapping.Data);
+}
+#else
+AssetFileView::Mapping *AssetFileMapper::Map(const bpf::String &path, AssetFileView::Mapping *current)
+{
+    int fd = open(*path, O_RDONLY | O_CLOEXEC);
+    struct stat st;
+    AssetFileView::FileIdentity identity;
+
+    if (fd == -1)
+        return (Null);
+    if (fstat(fd, &st) != 0)
+    {
+        close(fd);
+        return (Null);
+    }
+    identity.Device = static_cast<bpf::uint64>(st.st_dev);
+    identity.Inode = static_cast<bpf::uint64>(st.st_ino);
+    identity.Size = static_cast<bpf::uint64>(st.st_size);
+#ifdef LINUX
+    identity.ModifiedTime = static_cast<bpf::int64>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#else
+    identity.ModifiedTime = static_cast<bpf::int64>(st.st_mtime);
+#endif
+    if (current != Null && current->Identity == identity)
+    {
+        close(fd);
+        return (current);
+    }
+    auto mapping = bpf::memory::MemUtils::New<AssetFileView::Mapping>();
+    mapping->Identity = identity;
+    mapping->Size = static_cast<bpf::fsize>(identity.Size);
+    mapping->Data = Null;
+    if (mapping->Size > 0)
+    {
+        void *data = mmap(Null, mapping->Size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data != MAP_FAILED)
+            mapping->Data = static_cast<const bpf::uint8 *>(data);
+    }
+    close(fd); //The mapping keeps the file alive
+    if (mapping->Size > 0 && mapping->Data == Null)
+    {
+        bpf::memory::MemUtils::Delete(mapping);
+        return (Null);
+    }
+    return (mapping);
+}
+
+void AssetFileMapper::Unmap(AssetFileView::Mapping &mapping)
+{
+    if (mapping.Data != Null)
+        munmap(const_cast<bpf::uint8 *>(mapping.Data), mapping.Size);
+}
+#endif
+
+AssetFileMapper::~AssetFileMapper()
+{
+    for (auto &entry : _mappings)
+    {
+        Unmap(*entry.Value);
+        bpf::memory::MemUtils::Delete(entry.Value);
+    }
+}
+
+AssetFileView AssetFileMapper::Open(const bpf::io::File &file)
+{
+    auto lock = bpf::system::ScopeLock(_mutex);
+    auto path = file.Path();
+    auto current = _mappings.HasKey(path) ? _mappings[path] : Null;
+
+    //The file is checked on every open: the cached mapping may be of a previous version of the file
+    auto mapping = Map(path, current);
+    if (mapping == Null)
+        return (AssetFileView());
+    if (mapping == current)
+    {
+        mapping->Refs.fetch_add(1, std::memory_order_relaxed);
+        return (AssetFileView(mapping));
+    }
+    mapping->Owner = this;
+    mapping->Path = path;
+    mapping->Refs.store(1, std::memory_order_relaxed);
+    //A previous mapping still referenced by views is released by its last view
+    _mappings[path] = mapping;
+    return (AssetFileView(mapping));
+}
+
+AssetFileView AssetFileMapper::Open(const bpf::system::Paths &paths, const bpf::String &location)
+{
+    return (Open(AssetUrl::Resolve(paths, location)));
+}
+
+void AssetFileMapper::Release(AssetFileView::Mapping *mapping)
+{
+    auto lock = bpf::system::ScopeLock(_mutex);
+
+    if (mapping->Refs.fetch_sub(1, std::memory_order_acq_rel) != 1)
+        return;
+    if (_mappings.HasKey(mapping->Path) && _mappings[mapping->Path] == mapping)
+        _mappings.RemoveAt(mapping->Path); //A mapping replaced by a newer version of the file is no longer indexed
+    Unmap(*mapping);
+    bpf::memory::MemUtils::Delete(mapping);
+}
+
+bpf::fsize AssetFileMapper::GetMappedCount()
+{
+    auto lock = bpf::system::ScopeLock(_mutex);
+
+    return (_mappings.Size());
+}
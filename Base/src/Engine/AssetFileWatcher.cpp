@@ -0,0 +1,162 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#ifdef LINUX
+    #include <sys/inotify.h>
+    #include <unistd.h>
+#endif
+#include "Engine/AssetFileWatcher.hpp"
+
+using namespace bp3d;
+
+#ifdef LINUX
+AssetFileWatcher::AssetFileWatcher(const bpf::system::Paths &paths)
+    : _paths(paths)
+    , _fd(inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+{
+}
+
+AssetFileWatcher::~AssetFileWatcher()
+{
+    if (_fd != -1)
+        close(_fd);
+}
+
+bool AssetFileWatcher::IsSupported() const noexcept
+{
+    return (_fd != -1);
+}
+
+void AssetFileWatcher::Watch(const bpf::io::File &file, const bpf::Name &vpath)
+{
+    if (_fd == -1)
+        return;
+    auto path = file.Path();
+    auto sep = path.LastIndexOf('/');
+    if (sep <= 0)
+        return;
+    auto directory = path.Sub(0, sep);
+    if (!_watches.HasKey(directory))
+    {
+        //IN_CREATE is not watched: the file is still being written, IN_CLOSE_WRITE follows
+        int wd = inotify_add_watch(_fd, *directory, IN_CLOSE_WRITE | IN_MOVED_TO);
+        if (wd == -1)
+            return; //The directory does not exist or can not be watched
+        _watches.Add(directory, DirectoryWatch{wd, 0});
+        _directories.Add(wd, directory);
+    }
+    if (!_files.HasKey(path))
+        ++_watches[directory].Files;
+    auto &vpaths = _files[path];
+    for (auto &name : vpaths)
+    {
+        if (name == vpath)
+            return;
+    }
+    vpaths.Add(vpath);
+}
+
+void AssetFileWatcher::Unwatch(const bpf::io::File &file, const bpf::Name &vpath)
+{
+    auto path = file.Path();
+    if (!_files.HasKey(path))
+        return;
+    auto &vpaths = _files[path];
+    for (bpf::fsize i = 0; i != vpaths.Size(); ++i)
+    {
+        if (vpaths[i] == vpath)
+        {
+            vpaths.RemoveAt(i);
+            break;
+        }
+    }
+    if (vpaths.Size() > 0)
+        return;
+    _files.RemoveAt(path);
+    auto directory = path.Sub(0, path.LastIndexOf('/'));
+    auto &watch = _watches[directory];
+    if (--watch.Files > 0)
+        return;
+    inotify_rm_watch(_fd, watch.Descriptor);
+    _directories.RemoveAt(watch.Descriptor);
+    _watches.RemoveAt(directory);
+}
+
+void AssetFileWatcher::Poll(bpf::collection::ArrayList<bpf::Name> &changed)
+{
+    alignas(struct inotify_event) char buffer[4096];
+
+    if (_fd == -1)
+        return;
+    for (;;)
+    {
+        auto len = read(_fd, buffer, sizeof(buffer));
+        if (len <= 0)
+            return; //EAGAIN: no more events
+        for (char *ptr = buffer; ptr < buffer + len;)
+        {
+            auto event = reinterpret_cast<const struct inotify_event *>(ptr);
+            ptr += sizeof(struct inotify_event) + event->len;
+            if (event->len == 0 || !_directories.HasKey(event->wd))
+                continue;
+            auto path = _directories[event->wd] + '/' + bpf::String(event->name);
+            if (!_files.HasKey(path))
+                continue;
+            for (auto &vpath : _files[path])
+                changed.Add(vpath);
+        }
+    }
+}
+#else
+AssetFileWatcher::AssetFileWatcher(const bpf::system::Paths &paths)
+    : _paths(paths)
+    , _fd(-1)
+{
+}
+
+AssetFileWatcher::~AssetFileWatcher()
+{
+}
+
+bool AssetFileWatcher::IsSupported() const noexcept
+{
+    return (false);
+}
+
+void AssetFileWatcher::Watch(const bpf::io::File &, const bpf::Name &)
+{
+}
+
+void AssetFileWatcher::Unwatch(const bpf::io::File &, const bpf::Name &)
+{
+}
+
+void AssetFileWatcher::Poll(bpf::collection::ArrayList<bpf::Name> &)
+{
+}
+#endif
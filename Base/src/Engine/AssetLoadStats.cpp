@@ -0,0 +1,121 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <chrono>
+#include "Engine/AssetLoadStats.hpp"
+
+using namespace bp3d;
+
+AssetTimings &AssetTimings::operator+=(const AssetTimings &other) noexcept
+{
+    QueueWaitMicros += other.QueueWaitMicros;
+    BuildMicros += other.BuildMicros;
+    DependencyWaitMicros += other.DependencyWaitMicros;
+    MountMicros += other.MountMicros;
+    return (*this);
+}
+
+bpf::uint64 AssetTimings::Now() noexcept
+{
+    auto now = std::chrono::steady_clock::now().time_since_epoch();
+
+    return (static_cast<bpf::uint64>(std::chrono::duration_cast<std::chrono::microseconds>(now).count()));
+}
+
+LoadHistogram::LoadHistogram() noexcept
+    : _buckets()
+    , _count(0)
+    , _totalMicros(0)
+    , _maxMicros(0)
+{
+}
+
+void LoadHistogram::Add(bpf::uint64 micros) noexcept
+{
+    bpf::fsize bucket = 0;
+
+    while (bucket != BUCKET_COUNT - 1 && (micros >> bucket) != 0)
+        ++bucket;
+    ++_buckets[bucket];
+    ++_count;
+    _totalMicros += micros;
+    if (micros > _maxMicros)
+        _maxMicros = micros;
+}
+
+bpf::uint64 LoadHistogram::GetPercentileMicros(bpf::uint32 percentile) const noexcept
+{
+    if (_count == 0)
+        return (0);
+    auto rank = (_count * percentile + 99) / 100;
+    bpf::uint64 seen = 0;
+    for (bpf::fsize i = 0; i != BUCKET_COUNT; ++i)
+    {
+        seen += _buckets[i];
+        if (seen >= rank && seen != 0)
+        {
+            //Durations in bucket i are below 2^i, the largest recorded duration is a tighter bound
+            auto bound = (static_cast<bpf::uint64>(1) << i) - 1;
+            return (bound < _maxMicros ? bound : _maxMicros);
+        }
+    }
+    return (_maxMicros);
+}
+
+AssetLoadStats::AssetLoadStats() noexcept
+    : _count(0)
+{
+}
+
+void AssetLoadStats::Record(const AssetUrl &url, const AssetTimings &timings)
+{
+    auto &stats = _formats[url.GetProvider()];
+
+    if (stats.Format == bpf::String::Empty)
+        stats.Format = url.GetFormat();
+    stats.QueueWait.Add(timings.QueueWaitMicros);
+    stats.Build.Add(timings.BuildMicros);
+    stats.DependencyWait.Add(timings.DependencyWaitMicros);
+    stats.Mount.Add(timings.MountMicros);
+    _totals += timings;
+    ++_count;
+}
+
+const FormatLoadStats *AssetLoadStats::GetFormat(const bpf::Name &provider) const noexcept
+{
+    if (!_formats.HasKey(provider))
+        return (Null);
+    return (&_formats[provider]);
+}
+
+void AssetLoadStats::Clear()
+{
+    _formats = bpf::collection::HashMap<bpf::Name, FormatLoadStats>();
+    _totals = AssetTimings();
+    _count = 0;
+}
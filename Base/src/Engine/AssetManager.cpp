@@ -40,161 +40,992 @@ class BP3D_API SimpleAsset; //This forces MSVC to write the symbols inside of BP
 
 using namespace bp3d;
 
-void AssetManager::Add(const bpf::String &vpath, const bpf::String &url)
+bool AssetManager::CreateEntry(const bpf::String &vpath, const AssetUrl &url, EAssetPriority priority, ProviderCache &cache, AssetBuildPool::Entry &entry)
 {
-    _log.Info("Loading asset '[]' with url '[]'...", vpath, url);
-    auto arr = url.Explode(',');
-    if (arr.Size() != 2)
+    if (!url.IsValid())
     {
         _log.Error("Could not load asset '[]': incorrect asset url format", vpath);
-        return;
+        return (false);
     }
-    auto format = arr[0];
-    auto location = arr[1];
-    if (GetProvider(format) == Null)
+    if (cache.Provider == Null || cache.Format != url.GetProvider())
     {
-        _log.Error("Could not load asset '[]': no installed provider matches asset format ([])", vpath, format);
-        return;
+        cache.Format = url.GetProvider();
+        cache.Provider = GetProvider(url.GetProvider()).Raw();
+    }
+    if (cache.Provider == Null)
+    {
+        _log.Error("Could not load asset '[]': no installed provider matches asset format ([])", vpath, url.GetFormat());
+        return (false);
     }
     try
     {
-        auto ptr = GetProvider(format)->Create(location);
+        auto ptr = cache.Provider->Create(url.GetLocation());
         if (ptr == Null)
         {
             _log.Error("Could not load asset '[]': IAssetProvider failure", vpath);
-            return;
+            return (false);
         }
-        _thread.Add(vpath, std::move(ptr));
-        if (_thread.GetState() != bpf::system::Thread::RUNNING)
+        if (_watcher != Null)
+            _watcher->Watch(url.Resolve(_watcher->GetPaths()), bpf::Name(vpath));
+        auto buildCache = _pool.GetBuildCache();
+        if (buildCache != Null && ptr->GetCacheVersion() != 0)
         {
-            _thread.Join();
-            _thread.Start();
+            entry.Format = url.GetFormat();
+            entry.Source = url.Resolve(buildCache->GetPaths());
         }
+        entry.VPath = vpath;
+        entry.Builder = std::move(ptr);
+        entry.Priority = priority;
+        return (true);
     }
     catch (const bpf::RuntimeException &ex)
     {
         _log.Error("Could not load asset '[]': an unhandled exception has occured", vpath);
         _log.Error("        > []: []", ex.Type(), ex.Message());
+        return (false);
+    }
+}
+
+AssetHandle<Asset> AssetManager::Add(const bpf::String &vpath, const AssetUrl &url, EAssetPriority priority)
+{
+    ProviderCache cache;
+
+    _log.Info("Loading asset '[]' with url '[]'...", vpath, url);
+    AssetBuildPool::Entry entry;
+    if (!CreateEntry(vpath, url, priority, cache, entry))
+        return (AssetHandle<Asset>());
+    auto handle = ReserveSlot(vpath, url, priority);
+    entry.SlotIndex = handle.Index();
+    entry.SlotGeneration = handle.Generation();
+    _pool.Add(std::move(entry));
+    return (handle);
+}
+
+bpf::collection::ArrayList<AssetHandle<Asset>> AssetManager::AddBatch(const bpf::collection::ArrayList<bpf::Tuple<bpf::String, bpf::String>> &assets, EAssetPriority priority)
+{
+    ProviderCache cache;
+    bpf::collection::ArrayList<AssetBuildPool::Entry> entries;
+    bpf::collection::ArrayList<AssetHandle<Asset>> handles;
+
+    _log.Info("Loading [] assets...", assets.Size());
+    for (auto &tuple : assets)
+    {
+        const auto &vpath = tuple.Get<0>();
+        AssetUrl url(tuple.Get<1>());
+        AssetBuildPool::Entry entry;
+        if (!CreateEntry(vpath, url, priority, cache, entry))
+        {
+            handles.Add(AssetHandle<Asset>());
+            continue;
+        }
+        auto handle = ReserveSlot(vpath, url, priority);
+        entry.SlotIndex = handle.Index();
+        entry.SlotGeneration = handle.Generation();
+        handles.Add(handle);
+        entries.Add(std::move(entry));
     }
+    _pool.AddBatch(entries);
+    return (handles);
 }
 
 bpf::io::File AssetManager::GetAssetPath(const bpf::system::Paths &paths, const bpf::String &location)
 {
-    auto path = location.Replace("%Cache%", paths.CacheDir.Path())
-                    .Replace("%App%", paths.AppRoot.Path())
-                    .Replace("%Assets%", (paths.AppRoot + "Assets").Path());
-    return (bpf::io::File(path));
+    return (AssetUrl::Resolve(paths, location));
 }
 
-void AssetManager::Remove(const bpf::String &vpath)
+AssetHandle<Asset> AssetManager::ReserveSlot(const bpf::Name &vpath)
 {
-    bool glob = vpath.EndsWith("*");
-    bpf::String search;
+    bpf::uint32 index;
 
-    if (glob)
-        search = vpath.Sub(0, vpath.Len() - 1);
+    if (_slotIndex.HasKey(vpath))
+    {
+        index = _slotIndex[vpath];
+        return (AssetHandle<Asset>(index, _slots[index].Generation));
+    }
+    if (_freeSlots.Size() > 0)
+        index = _freeSlots.Pop();
     else
-        search = vpath;
-    for (auto &asset : _mountedAssets)
     {
-        if (glob && asset.Value->VirtualPath().StartsWith(search))
+        _slots.Add(AssetSlot());
+        index = static_cast<bpf::uint32>(_slots.Size() - 1);
+    }
+    _slotIndex.Add(vpath, index);
+    return (AssetHandle<Asset>(index, _slots[index].Generation));
+}
+
+AssetHandle<Asset> AssetManager::ReserveSlot(const bpf::String &vpath, const AssetUrl &url, EAssetPriority priority)
+{
+    auto handle = ReserveSlot(bpf::Name(vpath));
+    auto &slot = _slots[handle.Index()];
+
+    if (slot.VPath == bpf::String::Empty)
+        _pathIndex.Insert(vpath, handle.Index());
+    slot.VPath = vpath;
+    slot.Url = url;
+    slot.Priority = priority;
+    slot.Failed = false;
+    return (handle);
+}
+
+void AssetManager::ReleaseSlot(const bpf::Name &vpath)
+{
+    auto index = _slotIndex[vpath];
+
+    CompleteSlot(index, Null);
+    auto &slot = _slots[index];
+
+    if (slot.VPath != bpf::String::Empty)
+        _pathIndex.Remove(slot.VPath);
+    if (slot.Linked)
+    {
+        Unlink(index);
+        slot.Linked = false;
+    }
+    _cpuUsage -= slot.CPUSize;
+    _gpuUsage -= slot.GPUSize;
+    UnlinkType(index);
+    _registry.Publish(index, slot.Generation, Null);
+    _registry.Retire(std::move(slot.Ptr));
+    if (_watcher != Null && slot.Url.IsValid())
+        _watcher->Unwatch(slot.Url.Resolve(_watcher->GetPaths()), vpath);
+    ForgetDependencies(vpath);
+    slot.VPath = bpf::String::Empty;
+    slot.Url = AssetUrl();
+    slot.CPUSize = 0;
+    slot.GPUSize = 0;
+    slot.Evicted = false;
+    slot.ReloadRequested = false;
+    slot.Reloading = false;
+    slot.ChangedAgain = false;
+    slot.Failed = false;
+    slot.Timings = AssetTimings();
+    if (++slot.Generation == 0)
+        slot.Generation = 1;
+    _registry.Publish(index, slot.Generation, Null);
+    _slotIndex.RemoveAt(vpath);
+    _freeSlots.Push(index);
+}
+
+AssetHandle<Asset> AssetManager::MountAsset(const bpf::Name &vpath, bpf::memory::UniquePtr<Asset> &&ptr)
+{
+    auto handle = ReserveSlot(vpath);
+    auto index = handle.Index();
+    auto &slot = _slots[index];
+
+    if (slot.VPath == bpf::String::Empty)
+    {
+        slot.VPath = ptr->VirtualPath();
+        _pathIndex.Insert(slot.VPath, index);
+    }
+    _cpuUsage -= slot.CPUSize;
+    _gpuUsage -= slot.GPUSize;
+    slot.CPUSize = ptr->GetCPUSize();
+    slot.GPUSize = ptr->GetGPUSize();
+    _cpuUsage += slot.CPUSize;
+    _gpuUsage += slot.GPUSize;
+    auto previous = std::move(slot.Ptr);
+    slot.Ptr = std::move(ptr); //Replaces the previous instance, if any, without invalidating handles
+    if (slot.TypePos != NO_SLOT && slot.TypeId == slot.Ptr->TypeId())
+        _typeStorage[slot.TypeId].Assets[slot.TypePos] = slot.Ptr.Raw();
+    else
+    {
+        UnlinkType(index);
+        LinkType(index);
+    }
+    _registry.Publish(index, slot.Generation, slot.Ptr.Raw());
+    _registry.Retire(std::move(previous));
+    if (++slot.MountSerial == 0)
+        slot.MountSerial = 1;
+    slot.Evicted = false;
+    slot.ReloadRequested = false;
+    slot.Reloading = false;
+    slot.Failed = false;
+    if (slot.Linked)
+        Touch(index);
+    else if (slot.Url.IsValid())
+        Link(index);
+    ResolveDependents(vpath);
+    CompleteSlot(index, slot.Ptr.Raw());
+    ReloadIfChanged(index);
+    return (handle);
+}
+
+void AssetManager::CompleteSlot(bpf::uint32 index, Asset *ptr)
+{
+    if (!_continuations.HasKey(index))
+        return;
+    //Continuations may add or remove assets, detach them first
+    auto continuations = std::move(_continuations[index]);
+    auto generation = _slots[index].Generation;
+    _continuations.RemoveAt(index);
+    for (auto &continuation : continuations)
+    {
+        if (continuation.Generation == generation)
+            continuation.Function(ptr);
+    }
+}
+
+void AssetManager::FailSlot(const bpf::Name &vpath)
+{
+    if (!_slotIndex.HasKey(vpath))
+        return;
+    auto index = _slotIndex[vpath];
+    if (_slots[index].Ptr != Null)
+        return; //A failed reload keeps the mounted version
+    _slots[index].Failed = true;
+    CompleteSlot(index, Null);
+}
+
+void AssetManager::AddContinuation(const AssetHandle<Asset> &handle, std::function<void(Asset *)> &&fn)
+{
+    switch (GetState(handle))
+    {
+    case EAssetState::MOUNTED:
+        fn(_slots[handle.Index()].Ptr.Raw());
+        return;
+    case EAssetState::FAILED:
+        fn(Null);
+        return;
+    default:
+        break;
+    }
+    Continuation continuation;
+    continuation.Generation = handle.Generation();
+    continuation.Function = std::move(fn);
+    _continuations[handle.Index()].Add(std::move(continuation)); //Will update or create entry in continuations map
+}
+
+EAssetState AssetManager::GetState(const AssetHandle<Asset> &handle) const noexcept
+{
+    if (handle.Index() >= _slots.Size())
+        return (EAssetState::FAILED);
+    const auto &slot = _slots[handle.Index()];
+    if (slot.Generation != handle.Generation())
+        return (EAssetState::FAILED); //Removed
+    if (slot.Ptr != Null)
+        return (EAssetState::MOUNTED);
+    if (slot.Failed)
+        return (EAssetState::FAILED);
+    if (slot.Evicted && !slot.ReloadRequested)
+        return (EAssetState::EVICTED);
+    return (EAssetState::PENDING);
+}
+
+AssetTimings AssetManager::GetLoadTimings(const AssetHandle<Asset> &handle) const noexcept
+{
+    if (handle.Index() >= _slots.Size() || _slots[handle.Index()].Generation != handle.Generation())
+        return (AssetTimings());
+    return (_slots[handle.Index()].Timings);
+}
+
+bool AssetManager::Wait(const AssetHandle<Asset> &handle, std::chrono::milliseconds timeout)
+{
+    bpf::collection::ArrayList<AssetHandle<Asset>> handles;
+
+    handles.Add(handle);
+    return (Wait(handles, timeout));
+}
+
+bool AssetManager::Wait(const bpf::collection::ArrayList<AssetHandle<Asset>> &handles, std::chrono::milliseconds timeout)
+{
+    auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    for (;;)
+    {
+        bool pending = false;
+        for (auto &handle : handles)
         {
-            _log.Info("Unloading asset '[]'...", asset.Value->VirtualPath());
-            _mountedAssets[asset.Key] = Null;   //Force destruction of UniquePtr
-            _mountedAssets.RemoveAt(asset.Key); //Inform HashMap that slot can be reclaimed
+            if (GetState(handle) == EAssetState::PENDING)
+            {
+                pending = true;
+                break;
+            }
         }
-        else if (!glob && asset.Value->VirtualPath() == search)
-        {
-            _log.Info("Unloading asset '[]'...", asset.Value->VirtualPath());
-            _mountedAssets[asset.Key] = Null;   //Force destruction of UniquePtr
-            _mountedAssets.RemoveAt(asset.Key); //Inform HashMap that slot can be reclaimed
+        if (!pending)
+            return (true);
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+            return (false);
+        //Mounting is bounded by the remaining time so that a long mount queue can not overrun the timeout
+        if (Poll(std::chrono::duration_cast<std::chrono::microseconds>(deadline - now)).Mounted == 0)
+            bpf::system::Thread::Sleep(1); //Nothing to mount, give the workers some time
+    }
+}
+
+void AssetManager::Link(bpf::uint32 index)
+{
+    auto &slot = _slots[index];
+
+    slot.Linked = true;
+    slot.Prev = NO_SLOT;
+    slot.Next = _lruHead;
+    if (_lruHead != NO_SLOT)
+        _slots[_lruHead].Prev = index;
+    else
+        _lruTail = index;
+    _lruHead = index;
+}
+
+void AssetManager::Unlink(bpf::uint32 index) const noexcept
+{
+    const auto &slot = _slots[index];
+
+    if (slot.Prev != NO_SLOT)
+        _slots[slot.Prev].Next = slot.Next;
+    else
+        _lruHead = slot.Next;
+    if (slot.Next != NO_SLOT)
+        _slots[slot.Next].Prev = slot.Prev;
+    else
+        _lruTail = slot.Prev;
+}
+
+bool AssetManager::IsDefault(bpf::uint32 index) const noexcept
+{
+    for (auto &handle : _defaults)
+    {
+        if (handle.Index() == index && handle.Generation() == _slots[index].Generation)
+            return (true);
+    }
+    return (false);
+}
+
+void AssetManager::Evict(bpf::uint32 index)
+{
+    auto &slot = _slots[index];
+
+    _log.Info("Evicting asset '[]'...", slot.VPath);
+    Unlink(index);
+    slot.Linked = false;
+    _cpuUsage -= slot.CPUSize;
+    _gpuUsage -= slot.GPUSize;
+    slot.CPUSize = 0;
+    slot.GPUSize = 0;
+    UnlinkType(index);
+    _registry.Publish(index, slot.Generation, Null);
+    _registry.Retire(std::move(slot.Ptr)); //The slot is kept so that handles survive a reload
+    slot.Evicted = true;
+}
+
+void AssetManager::LinkType(bpf::uint32 index)
+{
+    auto &slot = _slots[index];
+    auto id = slot.Ptr->TypeId();
+
+    while (_typeStorage.Size() <= id)
+        _typeStorage.Add(TypeStorage());
+    auto &storage = _typeStorage[id];
+    slot.TypeId = id;
+    slot.TypePos = static_cast<bpf::uint32>(storage.Assets.Size());
+    storage.Assets.Add(slot.Ptr.Raw());
+    storage.Slots.Add(index);
+}
+
+void AssetManager::UnlinkType(bpf::uint32 index)
+{
+    auto &slot = _slots[index];
+
+    if (slot.TypePos == NO_SLOT)
+        return;
+    //Swap with the last asset of the same type to keep the storage packed
+    auto &storage = _typeStorage[slot.TypeId];
+    auto last = static_cast<bpf::uint32>(storage.Assets.Size() - 1);
+    if (slot.TypePos != last)
+    {
+        storage.Assets[slot.TypePos] = storage.Assets[last];
+        storage.Slots[slot.TypePos] = storage.Slots[last];
+        _slots[storage.Slots[slot.TypePos]].TypePos = slot.TypePos;
+    }
+    storage.Assets.RemoveLast();
+    storage.Slots.RemoveLast();
+    slot.TypePos = NO_SLOT;
+}
+
+void AssetManager::EnforceBudget()
+{
+    auto index = _lruTail;
+
+    while (index != NO_SLOT)
+    {
+        bool cpuOver = _cpuBudget != 0 && _cpuUsage > _cpuBudget;
+        bool gpuOver = _gpuBudget != 0 && _gpuUsage > _gpuBudget;
+        if (!cpuOver && !gpuOver)
             return;
+        const auto &slot = _slots[index];
+        auto prev = slot.Prev;
+        if (slot.Ptr->GetUseCount() == 0 && ((cpuOver && slot.CPUSize > 0) || (gpuOver && slot.GPUSize > 0))
+            && !IsDefault(index))
+            Evict(index);
+        index = prev;
+    }
+}
+
+void AssetManager::SetMemoryBudget(bpf::fsize cpuBytes, bpf::fsize gpuBytes)
+{
+    _cpuBudget = cpuBytes;
+    _gpuBudget = gpuBytes;
+    EnforceBudget();
+}
+
+void AssetManager::Reload(bpf::uint32 index)
+{
+    ProviderCache cache;
+    const auto &slot = _slots[index];
+
+    _log.Info("Reloading asset '[]'...", slot.VPath);
+    AssetBuildPool::Entry entry;
+    if (CreateEntry(slot.VPath, slot.Url, slot.Priority, cache, entry))
+    {
+        entry.SlotIndex = index;
+        entry.SlotGeneration = slot.Generation;
+        _pool.Add(std::move(entry));
+    }
+    else
+        CancelReload(bpf::Name(slot.VPath));
+}
+
+void AssetManager::ProcessReloadRequests()
+{
+    for (auto index : _reloadRequests)
+    {
+        //The slot may have been released or reloaded since the request
+        if (_slots[index].Evicted && _slots[index].ReloadRequested)
+            Reload(index);
+    }
+    _reloadRequests.Clear();
+}
+
+bool AssetManager::EnableHotReload(const bpf::system::Paths &paths)
+{
+    auto watcher = bpf::memory::MakeUnique<AssetFileWatcher>(paths);
+
+    if (!watcher->IsSupported())
+    {
+        _log.Warning("Hot reload is not supported on this platform");
+        return (false);
+    }
+    _watcher = std::move(watcher);
+    return (true);
+}
+
+bool AssetManager::EnableBuildCache(const bpf::system::Paths &paths)
+{
+    if (_pool.GetBuildCache() != Null)
+        return (true); //Workers may be using the current cache
+    auto cache = bpf::memory::MakeUnique<AssetBuildCache>(paths);
+
+    if (!cache->Initialize())
+    {
+        _log.Warning("Could not create the asset build cache directory, the build cache is disabled");
+        return (false);
+    }
+    _pool.SetBuildCache(std::move(cache));
+    return (true);
+}
+
+bool AssetManager::EnableTracing(const bpf::io::File &file)
+{
+    if (_pool.GetTracer() != Null)
+        return (true);
+    auto tracer = bpf::memory::MakeUnique<AssetTracer>(file);
+
+    if (!tracer->Start())
+    {
+        _log.Warning("Could not open trace file '[]', tracing is disabled", file.Path());
+        return (false);
+    }
+    _pool.SetTracer(std::move(tracer));
+    return (true);
+}
+
+void AssetManager::ProcessFileChanges()
+{
+    if (_watcher == Null)
+        return;
+    bpf::collection::ArrayList<bpf::Name> changed;
+    bpf::collection::HashMap<bpf::Name, bool> visited;
+    _watcher->Poll(changed);
+    //Breadth first walk of the assets built against the changed ones; changed grows as dependents are found
+    for (bpf::fsize i = 0; i < changed.Size(); ++i)
+    {
+        auto name = changed[i];
+        if (visited.HasKey(name) || !_slotIndex.HasKey(name))
+            continue;
+        visited.Add(name, true);
+        auto index = _slotIndex[name];
+        auto &slot = _slots[index];
+        if (slot.Ptr != Null && slot.Url.IsValid())
+        {
+            if (slot.Reloading)
+                slot.ChangedAgain = true; //The build in progress may have read the previous content
+            else
+            {
+                slot.Reloading = true;
+                Reload(index);
+            }
+        }
+        if (_reverseDependencies.HasKey(name))
+        {
+            for (auto &dependent : _reverseDependencies[name])
+                changed.Add(dependent);
         }
     }
 }
 
+void AssetManager::CancelReload(const bpf::Name &vpath)
+{
+    if (!_slotIndex.HasKey(vpath))
+        return;
+    auto &slot = _slots[_slotIndex[vpath]];
+    if (!slot.Reloading)
+        return;
+    //Keep the previous version and let assets waiting on the new one be built against it
+    slot.Reloading = false;
+    ResolveDependents(vpath);
+    ReloadIfChanged(_slotIndex[vpath]);
+}
+
+void AssetManager::ReloadIfChanged(bpf::uint32 index)
+{
+    auto &slot = _slots[index];
+    if (!slot.ChangedAgain)
+        return;
+    slot.ChangedAgain = false;
+    if (slot.Ptr == Null || slot.Reloading || !slot.Url.IsValid())
+        return;
+    slot.Reloading = true;
+    Reload(index);
+}
+
+bool AssetManager::IsMounted(const bpf::Name &vpath) const noexcept
+{
+    return (_slotIndex.HasKey(vpath) && _slots[_slotIndex[vpath]].Ptr != Null);
+}
+
+void AssetManager::RemoveEntry(const bpf::Name &name, const bpf::String &vpath)
+{
+    //Entries still building are cancelled, built entries not yet mounted are dropped
+    bool pending = _pool.Cancel(name);
+    if (_unresolved.HasKey(name))
+    {
+        DropUnresolved(name);
+        pending = true;
+    }
+    if (pending)
+        _log.Info("Cancelling pending asset '[]'...", vpath);
+    if (!_slotIndex.HasKey(name))
+        return;
+    if (IsMounted(name))
+        _log.Info("Unloading asset '[]'...", vpath);
+    ReleaseSlot(name);
+}
+
+void AssetManager::Remove(const bpf::String &vpath)
+{
+    if (!vpath.EndsWith("*"))
+    {
+        RemoveEntry(bpf::Name(vpath), vpath);
+        return;
+    }
+    bpf::collection::ArrayList<bpf::uint32> matches;
+    _pathIndex.ForEach(vpath.Sub(0, vpath.Len() - 1), [&](const bpf::uint32 slot) { matches.Add(slot); });
+    for (auto slot : matches)
+    {
+        auto path = _slots[slot].VPath;
+        RemoveEntry(bpf::Name(path), path);
+    }
+}
+
 void AssetManager::WaitForAllObjects()
 {
-    while (_thread.GetState() == bpf::system::Thread::RUNNING)
+    do
     {
-        _thread.Join();
+        _pool.WaitMountableEntries();
         while (Poll())
             ;
+    } while (_pool.HasPendingWork());
+}
+
+void AssetManager::QueueRefinement(const bpf::Name &vpath, AssetBuildPool::Entry &entry)
+{
+    //A reload in progress will mount a new coarse version
+    if (!entry.Builder->HasRefinement() || !_slotIndex.HasKey(vpath) || _slots[_slotIndex[vpath]].Reloading)
+        return;
+    AssetBuildPool::Entry refinement;
+    refinement.VPath = entry.VPath;
+    refinement.Builder = std::move(entry.Builder);
+    refinement.Priority = EAssetPriority::LOW;
+    refinement.RefineSerial = _slots[_slotIndex[vpath]].MountSerial;
+    refinement.SlotIndex = entry.SlotIndex;
+    refinement.SlotGeneration = entry.SlotGeneration;
+    _pool.Add(std::move(refinement));
+}
+
+AssetTimings AssetManager::RefineEntry(AssetBuildPool::Entry &entry)
+{
+    auto name = bpf::Name(entry.VPath);
+    AssetTimings timings;
+
+    if (entry.Error != bpf::String::Empty)
+    {
+        _log.Error("Could not refine asset '[]': an unhandled exception has occured", entry.VPath);
+        _log.Error("        > []", entry.Error);
+        return (timings);
     }
+    auto index = _slotIndex[name];
+    auto &slot = _slots[index];
+    if (slot.Ptr == Null || slot.MountSerial != entry.RefineSerial)
+        return (timings); //Evicted or replaced by a reload since the refinement was queued
+    auto start = AssetTimings::Now();
+    entry.Builder->Apply(*this, *slot.Ptr);
+    timings.MountMicros = AssetTimings::Now() - start;
+    AssetTracer *tracer = _pool.GetTracer();
+    if (tracer != Null)
+        tracer->Span("Apply", entry.VPath, start, start + timings.MountMicros);
+    _cpuUsage -= slot.CPUSize;
+    _gpuUsage -= slot.GPUSize;
+    slot.CPUSize = slot.Ptr->GetCPUSize();
+    slot.GPUSize = slot.Ptr->GetGPUSize();
+    _cpuUsage += slot.CPUSize;
+    _gpuUsage += slot.GPUSize;
+    QueueRefinement(name, entry);
+    return (timings);
 }
 
-bool AssetManager::AttemptSolveDependencies()
+AssetTimings AssetManager::MountEntry(AssetBuildPool::Entry &entry)
 {
-    if (_unresolved.Size() == 0)
+    if (entry.RefineSerial != 0)
+        return (RefineEntry(entry));
+    auto name = bpf::Name(entry.VPath);
+    auto timings = entry.Timings;
+    auto mountStart = AssetTimings::Now();
+    auto assetPtr = entry.Builder->Mount(*this, entry.VPath);
+    timings.MountMicros = AssetTimings::Now() - mountStart;
+    timings.DependencyWaitMicros = mountStart - entry.ReadyMicros;
+    AssetTracer *tracer = _pool.GetTracer();
+    if (tracer != Null)
+    {
+        tracer->AsyncSpan("DependencyWait", entry.VPath, entry.ReadyMicros, mountStart);
+        tracer->Span("Mount", entry.VPath, mountStart, mountStart + timings.MountMicros);
+    }
+    if (_slotIndex.HasKey(name))
+    {
+        auto &slot = _slots[_slotIndex[name]];
+        slot.Timings = timings;
+        if (slot.Url.IsValid())
+            _loadStats.Record(slot.Url, timings);
+    }
+    _log.Info("Successfully loaded asset '[]'", entry.VPath);
+    if (assetPtr != Null)
+    {
+        MountAsset(name, std::move(assetPtr));
+        QueueRefinement(name, entry);
+    }
+    else
+    {
+        CancelReload(name);
+        FailSlot(name); //No asset will ever be mounted for this entry
+    }
+    return (timings);
+}
+
+void AssetManager::DropUnresolved(const bpf::Name &vpath)
+{
+    //Forget the waiter so that a new entry for the same path is not resolved by the dependencies of this one
+    for (auto &dep : _unresolved[vpath].Entry.Builder->GetDependencies())
+    {
+        if (!_dependents.HasKey(dep))
+            continue;
+        auto &waiters = _dependents[dep];
+        for (bpf::fsize i = waiters.Size(); i-- > 0;)
+        {
+            if (waiters[i] == vpath)
+                waiters.RemoveAt(i);
+        }
+        if (waiters.Size() == 0)
+            _dependents.RemoveAt(dep);
+    }
+    _unresolved.RemoveAt(vpath);
+}
+
+void AssetManager::ForgetDependencies(const bpf::Name &vpath)
+{
+    if (!_builtAgainst.HasKey(vpath))
+        return;
+    for (auto &dep : _builtAgainst[vpath])
+    {
+        auto &dependents = _reverseDependencies[dep];
+        for (bpf::fsize i = 0; i != dependents.Size(); ++i)
+        {
+            if (dependents[i] == vpath)
+            {
+                dependents.RemoveAt(i);
+                break;
+            }
+        }
+        if (dependents.Size() == 0)
+            _reverseDependencies.RemoveAt(dep);
+    }
+    _builtAgainst.RemoveAt(vpath);
+}
+
+void AssetManager::ResolveDependents(const bpf::Name &vpath)
+{
+    if (!_dependents.HasKey(vpath))
+        return;
+    for (auto &waiter : _dependents[vpath])
+    {
+        if (!_unresolved.HasKey(waiter))
+            continue;
+        auto &node = _unresolved[waiter];
+        if (--node.Remaining == 0)
+        {
+            _mountReady[static_cast<bpf::fsize>(node.Entry.Priority)].Push(std::move(node.Entry));
+            _unresolved.RemoveAt(waiter);
+        }
+    }
+    _dependents.RemoveAt(vpath);
+}
+
+bool AssetManager::ScheduleEntry(AssetBuildPool::Entry &entry)
+{
+    if (entry.Error != bpf::String::Empty)
+    {
+        _log.Error("Could not build asset '[]': an unhandled exception has occured", entry.VPath);
+        _log.Error("        > []", entry.Error);
+        CancelReload(bpf::Name(entry.VPath));
+        FailSlot(bpf::Name(entry.VPath));
         return (false);
-    auto &entry = _unresolved.First();
-    bool solved = true;
+    }
+    const auto &expanded = entry.Builder->GetExpandedAssets();
+    for (auto &tuple : expanded)
+    {
+        auto vpath = entry.VPath + '/' + tuple.Get<0>();
+        auto url = tuple.Get<1>();
+        Add(vpath, url, entry.Priority);
+    }
+    auto name = bpf::Name(entry.VPath);
+    bpf::fsize remaining = 0;
+    //A rebuilt asset may no longer have the same dependencies
+    if (_watcher != Null)
+        ForgetDependencies(name);
     for (auto &dep : entry.Builder->GetDependencies())
     {
-        if (!_mountedAssets.HasKey(dep))
+        if (_watcher != Null)
         {
-            solved = false;
-            break;
+            auto &dependents = _reverseDependencies[dep];
+            bool found = false;
+            for (auto &dependent : dependents)
+            {
+                if (dependent == name)
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                dependents.Add(name);
+                _builtAgainst[name].Add(dep);
+            }
+        }
+        if (!IsMounted(dep) || _slots[_slotIndex[dep]].Reloading)
+        {
+            if (_slotIndex.HasKey(dep))
+            {
+                auto index = _slotIndex[dep];
+                if (_slots[index].Evicted && !_slots[index].ReloadRequested)
+                {
+                    _slots[index].ReloadRequested = true;
+                    Reload(index);
+                }
+            }
+            _dependents[dep].Add(name); //Will update or create entry in dependents map
+            ++remaining;
         }
     }
-    if (!solved)
+    if (remaining == 0)
+        return (true);
+    PendingMount node;
+    node.Entry = std::move(entry);
+    node.Remaining = remaining;
+    _unresolved.Add(name, std::move(node));
+    return (false);
+}
+
+bool AssetManager::HasCircularDependency(const bpf::Name &vpath, bpf::collection::HashMap<bpf::Name, int> &state)
+{
+    //0 = not visited, 1 = being visited, 2 = visited without cycle, 3 = visited and reaches a cycle
+    int st = state.HasKey(vpath) ? state[vpath] : 0;
+    if (st != 0)
+        return (st == 1 || st == 3);
+    state[vpath] = 1;
+    bool cycle = false;
+    for (auto &dep : _unresolved[vpath].Entry.Builder->GetDependencies())
     {
-        if (_thread.GetState() == bpf::system::Thread::FINISHED || _thread.GetState() == bpf::system::Thread::STOPPED)
+        if (_unresolved.HasKey(dep) && HasCircularDependency(dep, state))
         {
-            _log.Error("Could not build asset '[]': some dependencies were not satisfied", entry.VPath);
-            _unresolved.RemoveAt(_unresolved.begin());
-            return (true);
+            cycle = true;
+            break;
         }
-        return (true);
     }
-    else
+    state[vpath] = cycle ? 3 : 2;
+    return (cycle);
+}
+
+bool AssetManager::FailUnresolved()
+{
+    if (_unresolved.Size() == 0)
+        return (false);
+    //Entries still being built may satisfy the remaining dependencies
+    if (_pool.HasPendingWork())
+        return (false);
+    bpf::collection::HashMap<bpf::Name, int> state;
+    bpf::collection::ArrayList<bpf::Name> failed;
+    for (auto &node : _unresolved)
     {
-        auto assetPtr = entry.Builder->Mount(*this, entry.VPath);
-        if (assetPtr != Null)
-            _mountedAssets.Add(bpf::Name(entry.VPath), std::move(assetPtr));
-        _log.Info("Successfully loaded asset '[]'", entry.VPath);
-        _unresolved.RemoveAt(_unresolved.begin());
-        return (true);
+        if (HasCircularDependency(node.Key, state))
+            _log.Error("Could not build asset '[]': circular dependency detected", node.Value.Entry.VPath);
+        else
+            _log.Error("Could not build asset '[]': some dependencies were not satisfied", node.Value.Entry.VPath);
+        failed.Add(node.Key);
     }
+    _unresolved = bpf::collection::HashMap<bpf::Name, PendingMount>();
+    _dependents = bpf::collection::HashMap<bpf::Name, bpf::collection::ArrayList<bpf::Name>>();
+    for (auto &name : failed)
+        FailSlot(name);
+    return (true);
 }
 
-bool AssetManager::Poll(bpf::fsize maxMountable)
+bool AssetManager::IsCurrentEntry(const AssetBuildPool::Entry &entry) const noexcept
 {
-    while (maxMountable > 0)
+    auto name = bpf::Name(entry.VPath);
+
+    //The slot of a removed asset is released, which changes its generation even if the same path is added again
+    return (_slotIndex.HasKey(name) && _slotIndex[name] == entry.SlotIndex
+        && _slots[entry.SlotIndex].Generation == entry.SlotGeneration);
+}
+
+bool AssetManager::NextMountableEntry(AssetBuildPool::Entry &entry)
+{
+    AssetBuildPool::Entry built;
+    while (_pool.PollMountableEntry(built))
     {
-        AssetBuildThread::Entry entry;
-        --maxMountable;
-        if (!_thread.PollMountableEntry(entry))
-            return (AttemptSolveDependencies());
-        if (entry.Error != bpf::String::Empty)
+        if (!IsCurrentEntry(built))
+            continue; //Removed while building
+        //Refinements are neither expanded nor waiting on dependencies, their asset is already mounted
+        if (built.RefineSerial != 0 || ScheduleEntry(built))
+            _mountReady[static_cast<bpf::fsize>(built.Priority)].Push(std::move(built));
+    }
+    for (bpf::fsize p = ASSET_PRIORITY_COUNT; p-- > 0;)
+    {
+        while (_mountReady[p].Size() > 0)
         {
-            _log.Error("Could not build asset '[]': an unhandled exception has occured", entry.VPath);
-            _log.Error("        > []", entry.Error);
-            continue;
+            entry = _mountReady[p].Pop();
+            if (IsCurrentEntry(entry))
+                return (true);
+            //Removed while waiting to be mounted, possibly added again since then
         }
-        const auto &expanded = entry.Builder->GetExpandedAssets();
-        for (auto &tuple : expanded)
+    }
+    return (false);
+}
+
+bool AssetManager::Poll(bpf::fsize maxMountable)
+{
+    auto start = AssetTimings::Now();
+    bool more = true;
+
+    _lastPoll = PollStats();
+    ProcessFileChanges();
+    ProcessReloadRequests();
+    while (maxMountable > 0)
+    {
+        AssetBuildPool::Entry entry;
+        if (!NextMountableEntry(entry))
         {
-            auto vpath = entry.VPath + '/' + tuple.Get<0>();
-            auto url = tuple.Get<1>();
-            Add(vpath, url);
+            more = FailUnresolved();
+            break;
         }
-        bool solved = true;
-        for (auto &dep : entry.Builder->GetDependencies())
+        --maxMountable;
+        _lastPoll.Timings += MountEntry(entry);
+        ++_lastPoll.Mounted;
+    }
+    EnforceBudget();
+    _lastPoll.ElapsedMicros = AssetTimings::Now() - start;
+    _lastPoll.Pending = GetPendingCount();
+    _registry.Reclaim();
+    TraceQueues();
+    return (more);
+}
+
+void AssetManager::TraceQueues()
+{
+    AssetTracer *tracer = _pool.GetTracer();
+    if (tracer == Null)
+        return;
+    bpf::fsize mountable = 0;
+    auto now = AssetTimings::Now();
+
+    for (bpf::fsize p = 0; p != ASSET_PRIORITY_COUNT; ++p)
+        mountable += _mountReady[p].Size();
+    tracer->Counter("Building", now, _pool.GetPendingCount());
+    tracer->Counter("WaitingDependencies", now, _unresolved.Size());
+    tracer->Counter("Mountable", now, mountable);
+}
+
+PollStats AssetManager::Poll(std::chrono::microseconds budget)
+{
+    using Clock = std::chrono::steady_clock;
+    PollStats stats;
+    auto start = Clock::now();
+    auto limit = static_cast<bpf::uint64>(budget.count());
+
+    stats.Mounted = 0;
+    stats.ElapsedMicros = 0;
+    stats.Timings = AssetTimings();
+    ProcessFileChanges();
+    ProcessReloadRequests();
+    while (stats.Mounted == 0 || stats.ElapsedMicros + _mountCostMicros <= limit)
+    {
+        AssetBuildPool::Entry entry;
+        if (!NextMountableEntry(entry))
         {
-            if (!_mountedAssets.HasKey(dep))
-            {
-                _unresolved.Add(std::move(entry));
-                solved = false;
-                break;
-            }
+            FailUnresolved();
+            break;
         }
-        if (!solved)
-            continue;
-        auto assetPtr = entry.Builder->Mount(*this, entry.VPath);
-        if (assetPtr != Null)
-            _mountedAssets.Add(bpf::Name(entry.VPath), std::move(assetPtr));
-        _log.Info("Successfully loaded asset '[]'", entry.VPath);
+        auto mountStart = Clock::now();
+        stats.Timings += MountEntry(entry);
+        auto end = Clock::now();
+        auto cost = static_cast<bpf::uint64>(std::chrono::duration_cast<std::chrono::microseconds>(end - mountStart).count());
+        _mountCostMicros = (_mountCostMicros * 7 + cost) / 8;
+        stats.ElapsedMicros = static_cast<bpf::uint64>(std::chrono::duration_cast<std::chrono::microseconds>(end - start).count());
+        ++stats.Mounted;
     }
-    return (true);
+    EnforceBudget();
+    stats.ElapsedMicros = static_cast<bpf::uint64>(std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - start).count());
+    stats.Pending = GetPendingCount();
+    _lastPoll = stats;
+    _registry.Reclaim();
+    TraceQueues();
+    return (stats);
+}
+
+bpf::fsize AssetManager::GetPendingCount() const noexcept
+{
+    bpf::fsize count = _unresolved.Size() + _pool.GetPendingCount();
+
+    for (bpf::fsize p = 0; p != ASSET_PRIORITY_COUNT; ++p)
+        count += _mountReady[p].Size();
+    return (count);
+}
+
+bool AssetManager::SetPriority(const bpf::Name &vpath, EAssetPriority priority)
+{
+    //Entries waiting on dependencies are already built, only their mount order can change
+    if (_unresolved.HasKey(vpath))
+    {
+        _unresolved[vpath].Entry.Priority = priority;
+        return (true);
+    }
+    return (_pool.SetPriority(vpath, priority));
 }
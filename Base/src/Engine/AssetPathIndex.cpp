@@ -0,0 +1,78 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Engine/AssetPathIndex.hpp"
+
+using namespace bp3d;
+
+void AssetPathIndex::Insert(const bpf::String &vpath, bpf::uint32 slot)
+{
+    Node *node = &_root;
+
+    for (auto &segment : vpath.Explode('/'))
+    {
+        if (!node->Children.HasKey(segment))
+            node->Children.Add(segment, bpf::memory::MakeUnique<Node>());
+        node = node->Children[segment].Raw();
+    }
+    if (!node->HasSlot)
+        ++_size;
+    node->Slot = slot;
+    node->HasSlot = true;
+}
+
+bool AssetPathIndex::Remove(Node &node, const bpf::collection::ArrayList<bpf::String> &segments, bpf::fsize depth)
+{
+    if (depth == segments.Size())
+    {
+        if (!node.HasSlot)
+            return (false);
+        node.HasSlot = false;
+        return (true);
+    }
+    const auto &segment = segments[depth];
+    if (!node.Children.HasKey(segment))
+        return (false);
+    auto &child = node.Children[segment];
+    if (!Remove(*child, segments, depth + 1))
+        return (false);
+    if (!child->HasSlot && child->Children.Size() == 0)
+    {
+        node.Children[segment] = Null; //Force destruction of UniquePtr
+        node.Children.RemoveAt(segment); //Prune the now empty branch
+    }
+    return (true);
+}
+
+bool AssetPathIndex::Remove(const bpf::String &vpath)
+{
+    if (!Remove(_root, vpath.Explode('/'), 0))
+        return (false);
+    --_size;
+    return (true);
+}
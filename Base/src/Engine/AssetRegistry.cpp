@@ -0,0 +1,189 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <thread>
+#include <functional>
+#include <Framework/Memory/MemUtils.hpp>
+#include "Engine/AssetRegistry.hpp"
+
+using namespace bp3d;
+
+AssetReadGuard::AssetReadGuard(const AssetRegistry &registry) noexcept
+    : _registry(&registry)
+    , _participant(registry.Pin())
+{
+}
+
+AssetReadGuard::~AssetReadGuard()
+{
+    if (_registry != Null)
+        _registry->Unpin(_participant);
+}
+
+AssetRegistry::Chunk::Chunk()
+{
+    for (auto &entry : Entries)
+    {
+        entry.Ptr.store(Null, std::memory_order_relaxed);
+        entry.Generation.store(0, std::memory_order_relaxed);
+    }
+}
+
+AssetRegistry::AssetRegistry()
+    : _epoch(1)
+{
+    for (auto &chunk : _chunks)
+        chunk.store(Null, std::memory_order_relaxed);
+    for (auto &participant : _participants)
+        participant.Epoch.store(0, std::memory_order_relaxed);
+}
+
+AssetRegistry::~AssetRegistry()
+{
+    for (auto &chunk : _chunks)
+    {
+        auto ptr = chunk.load(std::memory_order_relaxed);
+        if (ptr != Null)
+            bpf::memory::MemUtils::Delete(ptr);
+    }
+}
+
+bpf::fsize AssetRegistry::Pin() const noexcept
+{
+    auto start = std::hash<std::thread::id>()(std::this_thread::get_id()) % MAX_PARTICIPANTS;
+
+    //A stale epoch only delays reclamation: the epoch can not advance past it while this participant is active
+    for (;;)
+    {
+        auto epoch = _epoch.load(std::memory_order_seq_cst);
+        for (bpf::fsize i = 0; i != MAX_PARTICIPANTS; ++i)
+        {
+            auto participant = (start + i) % MAX_PARTICIPANTS;
+            bpf::uint64 expected = 0;
+            if (_participants[participant].Epoch.compare_exchange_strong(expected, epoch, std::memory_order_seq_cst))
+                return (participant);
+        }
+        std::this_thread::yield();
+    }
+}
+
+void AssetRegistry::Unpin(const bpf::fsize participant) const noexcept
+{
+    _participants[participant].Epoch.store(0, std::memory_order_release);
+}
+
+bool AssetRegistry::HasReaders() const noexcept
+{
+    for (auto &participant : _participants)
+    {
+        if (participant.Epoch.load(std::memory_order_seq_cst) != 0)
+            return (true);
+    }
+    return (false);
+}
+
+bool AssetRegistry::TryAdvanceEpoch() noexcept
+{
+    auto epoch = _epoch.load(std::memory_order_relaxed); //Only the main thread writes the epoch
+
+    for (auto &participant : _participants)
+    {
+        auto pinned = participant.Epoch.load(std::memory_order_seq_cst);
+        if (pinned != 0 && pinned != epoch)
+            return (false);
+    }
+    _epoch.store(epoch + 1, std::memory_order_seq_cst);
+    return (true);
+}
+
+void AssetRegistry::Publish(const bpf::uint32 index, const bpf::uint32 generation, Asset *ptr)
+{
+    auto chunkIndex = index / CHUNK_SIZE;
+
+    if (chunkIndex >= MAX_CHUNKS)
+        return;
+    auto chunk = _chunks[chunkIndex].load(std::memory_order_relaxed);
+    if (chunk == Null)
+    {
+        chunk = bpf::memory::MemUtils::New<Chunk>();
+        _chunks[chunkIndex].store(chunk, std::memory_order_release);
+    }
+    auto &entry = chunk->Entries[index % CHUNK_SIZE];
+    //Readers check the generation before and after loading the pointer, so a pointer is never seen under another generation
+    if (entry.Generation.load(std::memory_order_relaxed) != generation)
+    {
+        entry.Ptr.store(Null, std::memory_order_seq_cst);
+        entry.Generation.store(generation, std::memory_order_release);
+    }
+    entry.Ptr.store(ptr, std::memory_order_seq_cst);
+}
+
+void AssetRegistry::Retire(bpf::memory::UniquePtr<Asset> ptr)
+{
+    //The asset is already unpublished: a reader pinned from now on can not reach it
+    if (ptr == Null || !HasReaders())
+        return;
+    Retired retired;
+    retired.Ptr = std::move(ptr);
+    retired.Epoch = _epoch.load(std::memory_order_seq_cst);
+    _retired.Push(std::move(retired));
+}
+
+void AssetRegistry::Reclaim()
+{
+    if (_retired.Size() == 0)
+        return;
+    if (!HasReaders())
+    {
+        _retired.Clear();
+        return;
+    }
+    TryAdvanceEpoch();
+    //An asset retired during epoch e may still be used by readers pinned at e, which are all gone once the epoch reaches e + 2
+    auto epoch = _epoch.load(std::memory_order_relaxed);
+    while (_retired.Size() > 0 && _retired.Top().Epoch + 2 <= epoch)
+        _retired.Pop();
+}
+
+Asset *AssetRegistry::Resolve(const AssetReadGuard &guard, const AssetHandle<Asset> &handle) const noexcept
+{
+    auto chunkIndex = handle.Index() / CHUNK_SIZE;
+
+    if (guard.GetRegistry() != this || chunkIndex >= MAX_CHUNKS)
+        return (Null);
+    auto chunk = _chunks[chunkIndex].load(std::memory_order_acquire);
+    if (chunk == Null)
+        return (Null);
+    const auto &entry = chunk->Entries[handle.Index() % CHUNK_SIZE];
+    if (entry.Generation.load(std::memory_order_acquire) != handle.Generation())
+        return (Null);
+    auto ptr = entry.Ptr.load(std::memory_order_seq_cst);
+    if (entry.Generation.load(std::memory_order_acquire) != handle.Generation())
+        return (Null);
+    return (ptr);
+}
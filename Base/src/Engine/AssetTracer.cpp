@@ -0,0 +1,221 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Engine/AssetTracer.hpp"
+
+using namespace bp3d;
+
+//Serialized events are written to the file once the buffer exceeds this size
+constexpr bpf::fsize WRITE_THRESHOLD = 65536;
+
+//The writer wakes up periodically instead of being notified, so that recording an event never takes a lock
+constexpr bpf::uint32 WRITER_PERIOD_MS = 10;
+
+class AssetTracer::Writer final : public bpf::system::Thread
+{
+private:
+    AssetTracer &_tracer;
+
+public:
+    explicit Writer(AssetTracer &tracer)
+        : bpf::system::Thread("AssetTracer")
+        , _tracer(tracer)
+    {
+    }
+
+    void Run() final
+    {
+        while (!_tracer._exit.load(std::memory_order_acquire))
+        {
+            if (!_tracer.WriteEvents())
+                bpf::system::Thread::Sleep(WRITER_PERIOD_MS);
+        }
+        _tracer.WriteEvents();
+    }
+};
+
+static void AppendEscaped(bpf::String &out, const bpf::String &str)
+{
+    for (bpf::fsize i = 0; i != str.Size(); ++i)
+    {
+        char c = str[i];
+        if (c == '"' || c == '\\')
+            out += '\\';
+        if (static_cast<unsigned char>(c) >= 0x20)
+            out += c;
+    }
+}
+
+AssetTracer::AssetTracer(const bpf::io::File &file, bpf::fsize capacity)
+    : _file(file)
+    , _events(capacity)
+    , _pending(0)
+    , _dropped(0)
+    , _nextId(0)
+    , _flushRequested(false)
+    , _exit(false)
+{
+}
+
+AssetTracer::~AssetTracer()
+{
+    if (_writer == Null)
+        return;
+    _exit.store(true, std::memory_order_release);
+    _writer->Join();
+    _buffer += "{}]\n"; //The trace event format tolerates a missing end but not a trailing comma
+    WriteBuffer();
+}
+
+bool AssetTracer::Start()
+{
+    try
+    {
+        _stream = bpf::memory::MakeUnique<bpf::io::FileStream>(_file, bpf::io::FILE_MODE_WRITE | bpf::io::FILE_MODE_TRUNCATE);
+    }
+    catch (const bpf::io::IOException &)
+    {
+        return (false);
+    }
+    _buffer = "[\n";
+    _writer = bpf::memory::MakeUnique<Writer>(*this);
+    _writer->Start();
+    return (true);
+}
+
+bpf::uint32 AssetTracer::GetThreadId() noexcept
+{
+    static std::atomic<bpf::uint32> next(0);
+    thread_local bpf::uint32 id = next.fetch_add(1, std::memory_order_relaxed);
+
+    return (id);
+}
+
+void AssetTracer::Push(Event &event)
+{
+    event.ThreadId = GetThreadId();
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    if (!_events.TryPush(event))
+    {
+        _pending.fetch_sub(1, std::memory_order_relaxed);
+        _dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void AssetTracer::Span(const char *name, const bpf::String &detail, bpf::uint64 start, bpf::uint64 end)
+{
+    Event event;
+
+    event.Name = name;
+    event.Phase = 'X';
+    event.Timestamp = start;
+    event.Value = end - start;
+    event.Detail = detail;
+    Push(event);
+}
+
+void AssetTracer::AsyncSpan(const char *name, const bpf::String &detail, bpf::uint64 start, bpf::uint64 end)
+{
+    auto id = _nextId.fetch_add(1, std::memory_order_relaxed);
+    Event begin;
+    Event finish;
+
+    begin.Name = name;
+    begin.Phase = 'b';
+    begin.Timestamp = start;
+    begin.Value = id;
+    begin.Detail = detail;
+    finish.Name = name;
+    finish.Phase = 'e';
+    finish.Timestamp = end;
+    finish.Value = id;
+    Push(begin);
+    Push(finish);
+}
+
+void AssetTracer::Counter(const char *name, bpf::uint64 timestamp, bpf::uint64 value)
+{
+    Event event;
+
+    event.Name = name;
+    event.Phase = 'C';
+    event.Timestamp = timestamp;
+    event.Value = value;
+    Push(event);
+}
+
+bool AssetTracer::WriteEvents()
+{
+    Event event;
+    bool any = false;
+
+    while (_events.TryPop(event))
+    {
+        any = true;
+        _buffer += bpf::String::Format("{\"name\":\"[]\",\"cat\":\"asset\",\"ph\":\"[]\",\"pid\":0,\"tid\":[],\"ts\":[]",
+                                       event.Name, event.Phase, event.ThreadId, event.Timestamp);
+        if (event.Phase == 'X')
+            _buffer += bpf::String::Format(",\"dur\":[]", event.Value);
+        else if (event.Phase == 'b' || event.Phase == 'e')
+            _buffer += bpf::String::Format(",\"id\":[]", event.Value);
+        if (event.Phase == 'C')
+            _buffer += bpf::String::Format(",\"args\":{\"value\":[]}", event.Value);
+        else if (event.Detail != bpf::String::Empty)
+        {
+            _buffer += ",\"args\":{\"asset\":\"";
+            AppendEscaped(_buffer, event.Detail);
+            _buffer += "\"}";
+        }
+        _buffer += "},\n";
+        _pending.fetch_sub(1, std::memory_order_release);
+    }
+    if (_buffer.Size() >= WRITE_THRESHOLD || _flushRequested.load(std::memory_order_acquire))
+    {
+        WriteBuffer();
+        _flushRequested.store(false, std::memory_order_release);
+    }
+    return (any);
+}
+
+void AssetTracer::WriteBuffer()
+{
+    _stream->Write(*_buffer, _buffer.Size());
+    _stream->Flush();
+    _buffer = bpf::String::Empty;
+}
+
+void AssetTracer::Flush()
+{
+    if (_writer == Null)
+        return;
+    while (_pending.load(std::memory_order_acquire) != 0)
+        bpf::system::Thread::Sleep(1);
+    _flushRequested.store(true, std::memory_order_release);
+    while (_flushRequested.load(std::memory_order_acquire))
+        bpf::system::Thread::Sleep(1);
+}
@@ -0,0 +1,72 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <atomic>
+#include <Framework/Collection/HashMap.hpp>
+#include <Framework/System/Mutex.hpp>
+#include <Framework/System/ScopeLock.hpp>
+#include "Engine/AssetType.hpp"
+
+using namespace bp3d;
+
+struct AssetTypeRegistry
+{
+    bpf::system::Mutex Mutex;
+    bpf::collection::HashMap<bpf::Name, bpf::uint32> Ids;
+    std::atomic<bpf::uint32> Count;
+
+    AssetTypeRegistry()
+        : Count(0)
+    {
+    }
+};
+
+//Constructed on first use to avoid depending on static initialization order
+static AssetTypeRegistry &GetRegistry()
+{
+    static AssetTypeRegistry registry;
+    return (registry);
+}
+
+bpf::uint32 AssetType::Register(const bpf::Name &type)
+{
+    auto &registry = GetRegistry();
+    auto lock = bpf::system::ScopeLock(registry.Mutex);
+
+    if (registry.Ids.HasKey(type))
+        return (registry.Ids[type]);
+    auto id = registry.Count.load(std::memory_order_relaxed);
+    registry.Ids.Add(type, id);
+    registry.Count.store(id + 1, std::memory_order_release);
+    return (id);
+}
+
+bpf::uint32 AssetType::GetCount() noexcept
+{
+    return (GetRegistry().Count.load(std::memory_order_acquire));
+}
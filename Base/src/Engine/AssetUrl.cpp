@@ -0,0 +1,120 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include "Engine/AssetUrl.hpp"
+
+using namespace bp3d;
+
+struct RootVariable
+{
+    const char *Name;
+    bpf::fisize Len;
+    EAssetRoot Root;
+};
+
+static const RootVariable ROOT_VARIABLES[] = {
+    {"%App%", 5, EAssetRoot::APP},
+    {"%Cache%", 7, EAssetRoot::CACHE},
+    {"%Assets%", 8, EAssetRoot::ASSETS}
+};
+
+AssetUrl::AssetUrl()
+    : _root(EAssetRoot::NONE)
+    , _pathStart(0)
+{
+}
+
+AssetUrl::AssetUrl(const bpf::String &url)
+    : _root(EAssetRoot::NONE)
+    , _pathStart(0)
+{
+    auto sep = url.IndexOf(',');
+
+    if (sep <= 0 || sep != url.LastIndexOf(',') || sep == url.Len() - 1)
+    {
+        _location = url;
+        return;
+    }
+    _format = url.Sub(0, sep);
+    _location = url.Sub(sep + 1);
+    _provider = bpf::Name(_format);
+    _root = ParseRoot(_location, _pathStart);
+}
+
+bpf::String AssetUrl::ToString() const
+{
+    if (!IsValid())
+        return (_location);
+    return (_format + ',' + _location);
+}
+
+EAssetRoot AssetUrl::ParseRoot(const bpf::String &location, bpf::fisize &pathStart)
+{
+    for (const auto &var : ROOT_VARIABLES)
+    {
+        if (location.StartsWith(var.Name))
+        {
+            pathStart = var.Len;
+            return (var.Root);
+        }
+    }
+    pathStart = 0;
+    return (EAssetRoot::NONE);
+}
+
+bpf::io::File AssetUrl::Resolve(const bpf::system::Paths &paths, const bpf::String &location, EAssetRoot root, bpf::fisize pathStart)
+{
+    auto path = location.Sub(pathStart);
+
+    //Root variables past the start of the location are rare, expand them the slow way
+    if (path.IndexOf('%') != -1)
+    {
+        path = path.Replace("%Cache%", paths.CacheDir.Path())
+                   .Replace("%App%", paths.AppRoot.Path())
+                   .Replace("%Assets%", (paths.AppRoot + "Assets").Path());
+    }
+    switch (root)
+    {
+    case EAssetRoot::APP:
+        return (bpf::io::File(paths.AppRoot.Path() + path));
+    case EAssetRoot::CACHE:
+        return (bpf::io::File(paths.CacheDir.Path() + path));
+    case EAssetRoot::ASSETS:
+        return (bpf::io::File((paths.AppRoot + "Assets").Path() + path));
+    default:
+        return (bpf::io::File(path));
+    }
+}
+
+bpf::io::File AssetUrl::Resolve(const bpf::system::Paths &paths, const bpf::String &location)
+{
+    bpf::fisize pathStart;
+    auto root = ParseRoot(location, pathStart);
+
+    return (Resolve(paths, location, root, pathStart));
+}
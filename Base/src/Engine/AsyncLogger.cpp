@@ -0,0 +1,168 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Framework/System/ScopeLock.hpp>
+#include "Engine/AsyncLogger.hpp"
+
+using namespace bp3d;
+
+class AsyncLogger::Worker final : public bpf::system::Thread
+{
+private:
+    AsyncLogger &_logger;
+
+public:
+    explicit Worker(AsyncLogger &logger)
+        : bpf::system::Thread("AsyncLogger")
+        , _logger(logger)
+    {
+    }
+
+    void Run() final
+    {
+        Record record;
+
+        while (_logger.WaitRecord(record))
+        {
+            _logger.Dispatch(record.GetLevel(), record.ToString());
+            record.Reset();
+            _logger._pending.fetch_sub(1, std::memory_order_release);
+        }
+    }
+};
+
+AsyncLogger::Record &AsyncLogger::Record::operator=(Record &&other) noexcept
+{
+    if (this == &other)
+        return (*this);
+    Reset();
+    _level = other._level;
+    _format = other._format;
+    if (other._ops != Null)
+    {
+        other._ops->Move(_args, other._args);
+        _ops = other._ops;
+        other.Reset();
+    }
+    return (*this);
+}
+
+void AsyncLogger::Record::Reset() noexcept
+{
+    if (_ops != Null)
+    {
+        _ops->Destroy(_args);
+        _ops = Null;
+    }
+}
+
+AsyncLogger::AsyncLogger(const bpf::String &category)
+    : _category(category)
+    , _pending(0)
+    , _sleeping(false)
+    , _exit(false)
+{
+}
+
+AsyncLogger::~AsyncLogger()
+{
+    if (_worker == Null)
+        return;
+    _mutex.Lock();
+    _exit = true;
+    _cond.NotifyAll();
+    _mutex.Unlock();
+    _worker->Join();
+}
+
+void AsyncLogger::AddHandler(bpf::memory::UniquePtr<bpf::log::ILogAdapter> &&ptr)
+{
+    auto lock = bpf::system::ScopeLock(_handlersMutex);
+
+    _handlers.Add(std::move(ptr));
+}
+
+void AsyncLogger::EnableAsync(bpf::fsize capacity)
+{
+    if (_queue != Null)
+        return;
+    _queue = bpf::memory::MakeUnique<RingQueue<Record>>(capacity);
+    _worker = bpf::memory::MakeUnique<Worker>(*this);
+    _worker->Start();
+}
+
+void AsyncLogger::Flush()
+{
+    while (_pending.load(std::memory_order_acquire) != 0)
+        bpf::system::Thread::Sleep(1);
+}
+
+void AsyncLogger::Dispatch(bpf::log::ELogLevel level, const bpf::String &msg)
+{
+    auto lock = bpf::system::ScopeLock(_handlersMutex);
+
+    for (auto &handler : _handlers)
+        handler->LogMessage(level, _category, msg);
+}
+
+void AsyncLogger::Push(Record &record)
+{
+    _pending.fetch_add(1, std::memory_order_relaxed);
+    //Never drop a message: wait for the background thread to make room if the ring buffer is full
+    while (!_queue->TryPush(record))
+        bpf::system::Thread::Sleep(1);
+    //Pairs with the fence in WaitRecord: either the worker sees the new record or we see it sleeping
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (_sleeping.load(std::memory_order_relaxed))
+    {
+        auto lock = bpf::system::ScopeLock(_mutex);
+        _cond.NotifyOne();
+    }
+}
+
+bool AsyncLogger::WaitRecord(Record &record)
+{
+    //Keeps draining after exit was requested so that no message is lost
+    while (!_exit.load(std::memory_order_relaxed) || _queue->GetSizeApprox() != 0)
+    {
+        if (_queue->TryPop(record))
+            return (true);
+        auto lock = bpf::system::ScopeLock(_mutex);
+        _sleeping.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (_queue->TryPop(record))
+        {
+            _sleeping.store(false, std::memory_order_relaxed);
+            return (true);
+        }
+        if (!_exit)
+            _cond.Wait(_mutex);
+        _sleeping.store(false, std::memory_order_relaxed);
+    }
+    return (false);
+}
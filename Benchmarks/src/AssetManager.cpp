@@ -0,0 +1,321 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#define BP_COMPAT_2_X
+#include <Engine/AssetManager.hpp>
+#include <Engine/SimpleAsset.hpp>
+#include <benchmark/benchmark.h>
+
+using namespace bp3d;
+
+class BenchBuilder final : public SimpleAsset
+{
+public:
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        return (bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), vpath));
+    }
+};
+
+class BenchProvider final : public IAssetProvider
+{
+public:
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<BenchBuilder>());
+    }
+};
+
+//Each asset depends on the assets listed in its location, separated by ';'
+class BenchDependencyBuilder final : public IAssetBuilder
+{
+private:
+    bpf::collection::List<bpf::Tuple<bpf::String, bpf::String>> _emptyExpanded;
+    bpf::collection::List<bpf::Name> _dependencies;
+
+public:
+    explicit BenchDependencyBuilder(const bpf::String &loc)
+    {
+        for (auto &dep : loc.Explode(';'))
+        {
+            if (dep != "none")
+                _dependencies.Add(bpf::Name(dep));
+        }
+    }
+
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    inline const bpf::collection::List<bpf::Tuple<bpf::String, bpf::String>> &GetExpandedAssets() const noexcept final
+    {
+        return (_emptyExpanded);
+    }
+
+    inline const bpf::collection::List<bpf::Name> &GetDependencies() const noexcept final
+    {
+        return (_dependencies);
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        return (bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), vpath));
+    }
+};
+
+class BenchDependencyProvider final : public IAssetProvider
+{
+public:
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &loc) final
+    {
+        return (bpf::memory::MakeUnique<BenchDependencyBuilder>(loc));
+    }
+};
+
+static bpf::collection::ArrayList<bpf::Tuple<bpf::String, bpf::String>> MakeManifest(bpf::fsize count)
+{
+    bpf::collection::ArrayList<bpf::Tuple<bpf::String, bpf::String>> manifest;
+
+    for (bpf::fsize i = 0; i != count; ++i)
+        manifest.Add(bpf::Tuple<bpf::String, bpf::String>(bpf::String::Format("Bench/[]", i), "bp3d::Asset/bench,%Assets%/bench.null"));
+    return (manifest);
+}
+
+static void BM_AssetManager_AddLoop(benchmark::State &state)
+{
+    auto manifest = MakeManifest(static_cast<bpf::fsize>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        {
+            AssetManager manager;
+            manager.SetProvider<Asset>("bench", bpf::memory::MakeUnique<BenchProvider>());
+            state.ResumeTiming();
+            for (auto &tuple : manifest)
+                manager.Add(tuple.Get<0>(), tuple.Get<1>());
+            state.PauseTiming();
+            manager.WaitForAllObjects();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_AssetManager_AddBatch(benchmark::State &state)
+{
+    auto manifest = MakeManifest(static_cast<bpf::fsize>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        {
+            AssetManager manager;
+            manager.SetProvider<Asset>("bench", bpf::memory::MakeUnique<BenchProvider>());
+            state.ResumeTiming();
+            manager.AddBatch(manifest);
+            state.PauseTiming();
+            manager.WaitForAllObjects();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//Asset i depends on asset (i - 1) / 2, dependents are queued before their dependencies so most of them wait in the unresolved set
+static bpf::collection::ArrayList<bpf::Tuple<bpf::String, bpf::String>> MakeDependencyManifest(bpf::fsize count)
+{
+    bpf::collection::ArrayList<bpf::Tuple<bpf::String, bpf::String>> manifest;
+
+    for (bpf::fsize i = count; i-- > 0;)
+    {
+        bpf::String url = i == 0 ? bpf::String("bp3d::Asset/dep,none") : bpf::String::Format("bp3d::Asset/dep,Bench/[]", (i - 1) / 2);
+        manifest.Add(bpf::Tuple<bpf::String, bpf::String>(bpf::String::Format("Bench/[]", i), url));
+    }
+    return (manifest);
+}
+
+static void SetupManager(AssetManager &manager, const bpf::collection::ArrayList<bpf::Tuple<bpf::String, bpf::String>> &manifest)
+{
+    manager.SetProvider<Asset>("bench", bpf::memory::MakeUnique<BenchProvider>());
+    manager.AddBatch(manifest);
+    manager.WaitForAllObjects();
+}
+
+//Time spent by Poll mounting built assets, builds are trivial so this is dominated by the main thread
+static void BM_AssetManager_Poll(benchmark::State &state)
+{
+    auto manifest = MakeManifest(static_cast<bpf::fsize>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        {
+            AssetManager manager;
+            manager.SetProvider<Asset>("bench", bpf::memory::MakeUnique<BenchProvider>());
+            manager.AddBatch(manifest);
+            state.ResumeTiming();
+            while (manager.GetPendingCount() > 0)
+                manager.Poll(manifest.Size());
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_AssetManager_GetHandle(benchmark::State &state)
+{
+    auto manifest = MakeManifest(static_cast<bpf::fsize>(state.range(0)));
+    bpf::collection::ArrayList<AssetHandle<Asset>> handles;
+    AssetManager manager;
+
+    SetupManager(manager, manifest);
+    for (auto &tuple : manifest)
+        handles.Add(manager.GetHandle<Asset>(bpf::Name(tuple.Get<0>())));
+    for (auto _ : state)
+    {
+        for (auto &handle : handles)
+            benchmark::DoNotOptimize(manager.Get(handle));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_AssetManager_GetName(benchmark::State &state)
+{
+    auto manifest = MakeManifest(static_cast<bpf::fsize>(state.range(0)));
+    bpf::collection::ArrayList<bpf::Name> names;
+    AssetManager manager;
+
+    SetupManager(manager, manifest);
+    for (auto &tuple : manifest)
+        names.Add(bpf::Name(tuple.Get<0>()));
+    for (auto _ : state)
+    {
+        for (auto &name : names)
+            benchmark::DoNotOptimize(manager.Get<Asset>(name));
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//Unloads all assets under a prefix while as many assets live under another prefix
+static void BM_AssetManager_RemoveGlob(benchmark::State &state)
+{
+    auto manifest = MakeManifest(static_cast<bpf::fsize>(state.range(0)));
+
+    for (auto &tuple : MakeManifest(static_cast<bpf::fsize>(state.range(0))))
+        manifest.Add(bpf::Tuple<bpf::String, bpf::String>(bpf::String("Other/") + tuple.Get<0>(), tuple.Get<1>()));
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        {
+            AssetManager manager;
+            SetupManager(manager, manifest);
+            state.ResumeTiming();
+            manager.Remove("Bench/*");
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//Sweeps all mounted assets of one type, half of the mounted assets are of another type
+static void BM_AssetManager_ForEachType(benchmark::State &state)
+{
+    auto manifest = MakeManifest(static_cast<bpf::fsize>(state.range(0)));
+    AssetManager manager;
+
+    SetupManager(manager, manifest);
+    for (bpf::fsize i = 0; i != manifest.Size(); ++i)
+        manager.Add<Asset>(bpf::memory::MakeUnique<Asset>(bpf::Name("bp3d::OtherAsset"), bpf::String::Format("Other/[]", i)));
+    for (auto _ : state)
+    {
+        bpf::fsize count = 0;
+        manager.ForEach<Asset>([&](Asset &asset) { count += asset.GetUseCount() + 1; });
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//Same sweep through the path index with a type check, for comparison
+static void BM_AssetManager_ForEachPrefix(benchmark::State &state)
+{
+    auto manifest = MakeManifest(static_cast<bpf::fsize>(state.range(0)));
+    AssetManager manager;
+
+    SetupManager(manager, manifest);
+    for (bpf::fsize i = 0; i != manifest.Size(); ++i)
+        manager.Add<Asset>(bpf::memory::MakeUnique<Asset>(bpf::Name("bp3d::OtherAsset"), bpf::String::Format("Other/[]", i)));
+    auto id = AssetType::Id<Asset>();
+    for (auto _ : state)
+    {
+        bpf::fsize count = 0;
+        manager.ForEach("", [&](Asset &asset) {
+            if (asset.TypeId() == id)
+                count += asset.GetUseCount() + 1;
+        });
+        benchmark::DoNotOptimize(count);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+//Add to fully mounted, including the resolution of the dependency tree
+static void BM_AssetManager_Dependencies(benchmark::State &state)
+{
+    auto manifest = MakeDependencyManifest(static_cast<bpf::fsize>(state.range(0)));
+
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        {
+            AssetManager manager;
+            manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<BenchDependencyProvider>());
+            state.ResumeTiming();
+            manager.AddBatch(manifest);
+            manager.WaitForAllObjects();
+            state.PauseTiming();
+        }
+        state.ResumeTiming();
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_AssetManager_AddLoop)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AssetManager_AddBatch)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AssetManager_Poll)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AssetManager_GetHandle)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AssetManager_GetName)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AssetManager_RemoveGlob)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_AssetManager_ForEachType)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AssetManager_ForEachPrefix)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMicrosecond);
+BENCHMARK(BM_AssetManager_Dependencies)->RangeMultiplier(10)->Range(1000, 100000)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,106 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/AssetUrl.hpp>
+#include <Framework/Collection/HashMap.hpp>
+#include <benchmark/benchmark.h>
+
+using namespace bp3d;
+
+static const bpf::String URL = "bp3d::Asset/bench,%Assets%/textures/bench.png";
+
+static bpf::system::Paths MakePaths()
+{
+    return (bpf::system::Paths(bpf::io::File("/app"), bpf::io::File(), bpf::io::File(), bpf::io::File("/cache")));
+}
+
+//Previous AssetManager behavior: split the url on every Add and look the provider up by string
+static void BM_AssetUrl_Explode(benchmark::State &state)
+{
+    bpf::collection::HashMap<bpf::String, int> providers;
+    providers.Add("bp3d::Asset/bench", 1);
+
+    for (auto _ : state)
+    {
+        auto arr = URL.Explode(',');
+        benchmark::DoNotOptimize(providers[arr[0]]);
+        benchmark::DoNotOptimize(arr[1]);
+    }
+}
+
+static void BM_AssetUrl_Parse(benchmark::State &state)
+{
+    bpf::collection::HashMap<bpf::Name, int> providers;
+    providers.Add(bpf::Name("bp3d::Asset/bench"), 1);
+
+    for (auto _ : state)
+    {
+        AssetUrl url(URL);
+        benchmark::DoNotOptimize(providers[url.GetProvider()]);
+    }
+}
+
+static void BM_AssetUrl_PreParsed(benchmark::State &state)
+{
+    bpf::collection::HashMap<bpf::Name, int> providers;
+    providers.Add(bpf::Name("bp3d::Asset/bench"), 1);
+    AssetUrl url(URL);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(providers[url.GetProvider()]);
+}
+
+//Previous AssetManager::GetAssetPath: one Replace per root variable
+static void BM_AssetUrl_ResolveReplace(benchmark::State &state)
+{
+    auto paths = MakePaths();
+    AssetUrl url(URL);
+
+    for (auto _ : state)
+    {
+        auto path = url.GetLocation().Replace("%Cache%", paths.CacheDir.Path())
+                        .Replace("%App%", paths.AppRoot.Path())
+                        .Replace("%Assets%", (paths.AppRoot + "Assets").Path());
+        benchmark::DoNotOptimize(path);
+    }
+}
+
+static void BM_AssetUrl_Resolve(benchmark::State &state)
+{
+    auto paths = MakePaths();
+    AssetUrl url(URL);
+
+    for (auto _ : state)
+        benchmark::DoNotOptimize(url.Resolve(paths));
+}
+
+BENCHMARK(BM_AssetUrl_Explode);
+BENCHMARK(BM_AssetUrl_Parse);
+BENCHMARK(BM_AssetUrl_PreParsed);
+BENCHMARK(BM_AssetUrl_ResolveReplace);
+BENCHMARK(BM_AssetUrl_Resolve);
@@ -0,0 +1,70 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/RingQueue.hpp>
+#include <Framework/System/Mutex.hpp>
+#include <Framework/System/ScopeLock.hpp>
+#include <Framework/Collection/Queue.hpp>
+#include <benchmark/benchmark.h>
+
+//Each thread pushes then pops one value per iteration, all threads share the same queue
+
+static bpf::collection::Queue<bpf::fsize> MutexQueue;
+static bpf::system::Mutex QueueMutex;
+
+static void BM_MutexQueue(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        {
+            auto lock = bpf::system::ScopeLock(QueueMutex);
+            MutexQueue.Push(state.iterations());
+        }
+        {
+            auto lock = bpf::system::ScopeLock(QueueMutex);
+            if (MutexQueue.Size() > 0)
+                benchmark::DoNotOptimize(MutexQueue.Pop());
+        }
+    }
+}
+
+static bp3d::RingQueue<bpf::fsize> LockFreeQueue(4096);
+
+static void BM_RingQueue(benchmark::State &state)
+{
+    for (auto _ : state)
+    {
+        bpf::fsize val = state.iterations();
+        LockFreeQueue.TryPush(val);
+        if (LockFreeQueue.TryPop(val))
+            benchmark::DoNotOptimize(val);
+    }
+}
+
+BENCHMARK(BM_MutexQueue)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_RingQueue)->ThreadRange(1, 8)->UseRealTime();
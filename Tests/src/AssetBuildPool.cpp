@@ -0,0 +1,82 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/AssetBuildPool.hpp>
+#include <Engine/SimpleAsset.hpp>
+#include <Framework/System/Thread.hpp>
+#include <gtest/gtest.h>
+
+using namespace bp3d;
+
+class NullBuilder final : public SimpleAsset
+{
+public:
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &) final
+    {
+        return (nullptr);
+    }
+};
+
+TEST(AssetBuildPool, Overflow)
+{
+    AssetBuildPool pool(2, 1, 4);
+    AssetBuildPool::Entry entry;
+    bpf::fsize count = 0;
+
+    for (bpf::fsize i = 0; i != 64; ++i)
+        pool.Add(bpf::String::Format("Test/[]", i), bpf::memory::MakeUnique<NullBuilder>());
+    while (pool.HasPendingWork())
+    {
+        pool.WaitMountableEntries();
+        while (pool.PollMountableEntry(entry))
+        {
+            EXPECT_EQ(entry.Error, bpf::String::Empty);
+            ++count;
+        }
+    }
+    EXPECT_EQ(count, 64u);
+}
+
+TEST(AssetBuildPool, Overflow_Destroy)
+{
+    //The destructor must not wait for the main thread to make room in the mountable queues
+    {
+        AssetBuildPool pool(2, 1, 4);
+
+        //Each Add refills the pending queue so that the workers end up waiting for room in the full mountable queue
+        for (bpf::fsize i = 0; i != 64; ++i)
+        {
+            pool.Add(bpf::String::Format("Test/[]", i), bpf::memory::MakeUnique<NullBuilder>());
+            bpf::system::Thread::Sleep(1);
+        }
+    }
+}
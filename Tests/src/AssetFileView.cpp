@@ -0,0 +1,143 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <cstring>
+#include <thread>
+#include <Engine/AssetFileView.hpp>
+#include <Framework/IO/FileStream.hpp>
+#include <Framework/System/Thread.hpp>
+#include <gtest/gtest.h>
+
+using namespace bp3d;
+
+static void WriteViewFile(const bpf::io::File &file, const bpf::String &content)
+{
+    bpf::io::FileStream stream(file, bpf::io::FILE_MODE_WRITE | bpf::io::FILE_MODE_TRUNCATE);
+    stream.Write(*content, content.Size());
+}
+
+TEST(AssetFileView, Share)
+{
+    AssetFileMapper mapper;
+    bpf::io::File file("./AssetFileView_A.txt");
+
+    WriteViewFile(file, "Hello mapped world");
+    {
+        auto view = mapper.Open(file);
+        ASSERT_TRUE(view.IsValid());
+        EXPECT_EQ(view.Size(), 18u);
+        EXPECT_EQ(std::memcmp(view.Data(), "Hello mapped world", 18), 0);
+        auto other = mapper.Open(bpf::system::Paths(bpf::io::File("."), bpf::io::File(), bpf::io::File(), bpf::io::File()), "%App%/AssetFileView_A.txt");
+        auto copy = other;
+        EXPECT_EQ(mapper.GetMappedCount(), 1u);
+        EXPECT_EQ(other.Data(), view.Data());
+        EXPECT_EQ(copy.Data(), view.Data());
+        view = AssetFileView();
+        EXPECT_FALSE(view.IsValid());
+        EXPECT_EQ(mapper.GetMappedCount(), 1u);
+        other = std::move(copy);
+        EXPECT_FALSE(copy.IsValid());
+        EXPECT_EQ(mapper.GetMappedCount(), 1u);
+    }
+    EXPECT_EQ(mapper.GetMappedCount(), 0u);
+    EXPECT_TRUE(file.Delete());
+}
+
+TEST(AssetFileView, Invalid)
+{
+    AssetFileMapper mapper;
+    bpf::io::File file("./AssetFileView_Empty.txt");
+
+    EXPECT_FALSE(mapper.Open(bpf::io::File("./AssetFileView_Missing.txt")).IsValid());
+    EXPECT_EQ(mapper.GetMappedCount(), 0u);
+    WriteViewFile(file, "");
+    auto view = mapper.Open(file);
+    EXPECT_TRUE(view.IsValid());
+    EXPECT_EQ(view.Size(), 0u);
+    EXPECT_EQ(view.Data(), nullptr);
+    view = AssetFileView();
+    EXPECT_TRUE(file.Delete());
+}
+
+TEST(AssetFileView, Rewrite)
+{
+    AssetFileMapper mapper;
+    bpf::io::File file("./AssetFileView_C.txt");
+
+    WriteViewFile(file, "Old");
+    auto old = mapper.Open(file);
+    ASSERT_TRUE(old.IsValid());
+    EXPECT_EQ(old.Size(), 3u);
+    WriteViewFile(file, "New content");
+    auto view = mapper.Open(file);
+    ASSERT_TRUE(view.IsValid());
+    EXPECT_NE(view.Data(), old.Data());
+    EXPECT_EQ(view.Size(), 11u);
+    EXPECT_EQ(std::memcmp(view.Data(), "New content", 11), 0);
+    EXPECT_EQ(old.Size(), 3u); //The previous mapping lives until its views are destroyed
+    old = AssetFileView();
+    EXPECT_EQ(mapper.GetMappedCount(), 1u); //Releasing the previous mapping keeps the current one
+    auto copy = mapper.Open(file);
+    EXPECT_EQ(copy.Data(), view.Data());
+    bpf::system::Thread::Sleep(50); //Lets the modification time change
+    WriteViewFile(file, "Other bytes");
+    auto same = mapper.Open(file);
+    ASSERT_TRUE(same.IsValid());
+    EXPECT_NE(same.Data(), view.Data());
+    EXPECT_EQ(std::memcmp(same.Data(), "Other bytes", 11), 0);
+    view = AssetFileView();
+    copy = AssetFileView();
+    same = AssetFileView();
+    EXPECT_EQ(mapper.GetMappedCount(), 0u);
+    EXPECT_TRUE(file.Delete());
+}
+
+TEST(AssetFileView, Threads)
+{
+    AssetFileMapper mapper;
+    bpf::io::File file("./AssetFileView_B.txt");
+    std::thread threads[4];
+
+    WriteViewFile(file, "B");
+    for (auto &thread : threads)
+    {
+        thread = std::thread([&]() {
+            for (int i = 0; i != 1000; ++i)
+            {
+                auto view = mapper.Open(file);
+                auto copy = view;
+                EXPECT_EQ(copy.Size(), 1u);
+                EXPECT_EQ(copy.Data()[0], 'B');
+            }
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    EXPECT_EQ(mapper.GetMappedCount(), 0u);
+    EXPECT_TRUE(file.Delete());
+}
@@ -0,0 +1,76 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/AssetLoadStats.hpp>
+#include <gtest/gtest.h>
+
+using namespace bp3d;
+
+TEST(AssetLoadStats, Histogram)
+{
+    LoadHistogram histogram;
+
+    EXPECT_EQ(histogram.GetPercentileMicros(50), 0u);
+    histogram.Add(0);
+    histogram.Add(3);
+    histogram.Add(100);
+    histogram.Add(1000);
+    EXPECT_EQ(histogram.GetCount(), 4u);
+    EXPECT_EQ(histogram.GetTotalMicros(), 1103u);
+    EXPECT_EQ(histogram.GetMaxMicros(), 1000u);
+    EXPECT_EQ(histogram.GetMeanMicros(), 275u);
+    EXPECT_EQ(histogram.GetBucket(0), 1u);
+    EXPECT_EQ(histogram.GetBucket(2), 1u); //3 < 2^2
+    EXPECT_EQ(histogram.GetBucket(7), 1u); //100 < 2^7
+    EXPECT_EQ(histogram.GetBucket(10), 1u); //1000 < 2^10
+    EXPECT_EQ(histogram.GetPercentileMicros(50), 3u);
+    EXPECT_EQ(histogram.GetPercentileMicros(75), 127u);
+    EXPECT_EQ(histogram.GetPercentileMicros(100), 1000u);
+    histogram.Add(static_cast<bpf::uint64>(1) << 40);
+    EXPECT_EQ(histogram.GetBucket(LoadHistogram::BUCKET_COUNT - 1), 1u);
+}
+
+TEST(AssetLoadStats, Record)
+{
+    AssetLoadStats stats;
+    AssetTimings timings;
+
+    timings.BuildMicros = 10;
+    timings.MountMicros = 5;
+    stats.Record(AssetUrl("bp3d::Asset/a,none"), timings);
+    stats.Record(AssetUrl("bp3d::Asset/a,other"), timings);
+    stats.Record(AssetUrl("bp3d::Asset/b,none"), timings);
+    EXPECT_EQ(stats.GetCount(), 3u);
+    EXPECT_EQ(stats.GetTotals().BuildMicros, 30u);
+    EXPECT_EQ(stats.GetTotals().MountMicros, 15u);
+    EXPECT_EQ(stats.GetFormats().Size(), 2u);
+    EXPECT_EQ(stats.GetFormat(bpf::Name("bp3d::Asset/a"))->Build.GetCount(), 2u);
+    stats.Clear();
+    EXPECT_EQ(stats.GetCount(), 0u);
+    EXPECT_EQ(stats.GetFormat(bpf::Name("bp3d::Asset/a")), nullptr);
+}
@@ -27,9 +27,14 @@
 // SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
 
 #define BP_COMPAT_2_X
+#include <atomic>
+#include <memory>
+#include <thread>
 #include "ListLogHandler.hpp"
 #include <Engine/AssetManager.hpp>
 #include <Engine/SimpleAsset.hpp>
+#include <Engine/StagedAsset.hpp>
+#include <Framework/IO/FileStream.hpp>
 #include <gtest/gtest.h>
 
 using namespace bp3d;
@@ -55,7 +60,7 @@ public:
 class ExceptionBuilder final : public SimpleAsset
 {
 public:
-    void Build() final
+    void Build(const CancellationToken &) final
     {
         throw bpf::RuntimeException("Well", "This is definately a failure!");
     }
@@ -79,7 +84,7 @@ public:
     {
     }
 
-    void Build() final
+    void Build(const CancellationToken &) final
     {
         bpf::system::Thread::Sleep(100); //Simulate long running work
         if (_loc.EndsWith("test.null"))
@@ -218,3 +223,1263 @@ TEST(AssetManager, Get)
     EXPECT_EQ(manager.Get<Asset>(bpf::Name()), nullptr);
     EXPECT_EQ(manager.Get<bpf::memory::Object>(bpf::Name("Test/Null")), nullptr); //Unrelated type with no default should return null
 }
+
+TEST(AssetManager, Builder_Parallel)
+{
+    AssetManager manager(4);
+
+    manager.SetProvider<Asset>("null", bpf::memory::MakeUnique<SuperProvider>(bpf::system::Paths(bpf::io::File(), bpf::io::File(), bpf::io::File(), bpf::io::File()), false));
+    for (bpf::fsize i = 0; i != 16; ++i)
+        manager.Add(bpf::String::Format("Test/Parallel/[]", i), "bp3d::Asset/null,%Assets%/parallel.null");
+    manager.WaitForAllObjects();
+    for (bpf::fsize i = 0; i != 16; ++i)
+        EXPECT_NE(manager.Get<Asset>(bpf::Name(bpf::String::Format("Test/Parallel/[]", i))), nullptr);
+}
+
+TEST(AssetManager, Builder_Trickle)
+{
+    AssetManager manager(1);
+
+    manager.SetProvider<Asset>("null", bpf::memory::MakeUnique<SuperProvider>(bpf::system::Paths(bpf::io::File(), bpf::io::File(), bpf::io::File(), bpf::io::File()), false));
+    for (bpf::fsize i = 0; i != 4; ++i)
+    {
+        manager.Add(bpf::String::Format("Test/Trickle/[]", i), "bp3d::Asset/null,%Assets%/trickle.null");
+        manager.WaitForAllObjects();
+        EXPECT_NE(manager.Get<Asset>(bpf::Name(bpf::String::Format("Test/Trickle/[]", i))), nullptr);
+    }
+}
+
+class DependencyBuilder final : public IAssetBuilder
+{
+private:
+    bpf::collection::List<bpf::Tuple<bpf::String, bpf::String>> _emptyExpanded;
+    bpf::collection::List<bpf::Name> _dependencies;
+
+public:
+    explicit DependencyBuilder(const bpf::String &loc)
+    {
+        for (auto &dep : loc.Explode(';'))
+        {
+            if (dep != "none")
+                _dependencies.Add(bpf::Name(dep));
+        }
+    }
+
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    inline const bpf::collection::List<bpf::Tuple<bpf::String, bpf::String>> &GetExpandedAssets() const noexcept final
+    {
+        return (_emptyExpanded);
+    }
+
+    inline const bpf::collection::List<bpf::Name> &GetDependencies() const noexcept final
+    {
+        return (_dependencies);
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &assets, const bpf::String &vpath) final
+    {
+        for (auto &dep : _dependencies)
+            EXPECT_NE(assets.Get<Asset>(dep), nullptr);
+        return (bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), vpath));
+    }
+};
+
+class DependencyProvider final : public IAssetProvider
+{
+public:
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &loc) final
+    {
+        return (bpf::memory::MakeUnique<DependencyBuilder>(loc));
+    }
+};
+
+TEST(AssetManager, Dependencies)
+{
+    bpf::collection::List<bpf::String> logs;
+    AssetManager manager;
+
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    manager.AddLogHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    manager.Add("Test/A", "bp3d::Asset/dep,Test/B;Test/C");
+    manager.Add("Test/B", "bp3d::Asset/dep,Test/C");
+    manager.Add("Test/D", "bp3d::Asset/dep,Test/A");
+    manager.Add("Test/C", "bp3d::Asset/dep,none");
+    manager.WaitForAllObjects();
+    EXPECT_NE(manager.Get<Asset>(bpf::Name("Test/A")), nullptr);
+    EXPECT_NE(manager.Get<Asset>(bpf::Name("Test/B")), nullptr);
+    EXPECT_NE(manager.Get<Asset>(bpf::Name("Test/C")), nullptr);
+    EXPECT_NE(manager.Get<Asset>(bpf::Name("Test/D")), nullptr);
+    for (auto &log : logs)
+        EXPECT_FALSE(log.StartsWith("[ERROR]"));
+}
+
+TEST(AssetManager, Dependencies_Missing)
+{
+    bpf::collection::List<bpf::String> logs;
+    AssetManager manager;
+
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    manager.AddLogHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    manager.Add("Test/A", "bp3d::Asset/dep,Test/Missing");
+    manager.WaitForAllObjects();
+    EXPECT_EQ(manager.Get<Asset>(bpf::Name("Test/A")), nullptr);
+    EXPECT_STREQ(*logs.Last(), "[ERROR]AssetManager> Could not build asset 'Test/A': some dependencies were not satisfied");
+}
+
+TEST(AssetManager, Dependencies_Circular)
+{
+    bpf::collection::List<bpf::String> logs;
+    AssetManager manager;
+
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    manager.AddLogHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    manager.Add("Test/A", "bp3d::Asset/dep,Test/B");
+    manager.Add("Test/B", "bp3d::Asset/dep,Test/A");
+    manager.WaitForAllObjects();
+    EXPECT_EQ(manager.Get<Asset>(bpf::Name("Test/A")), nullptr);
+    EXPECT_EQ(manager.Get<Asset>(bpf::Name("Test/B")), nullptr);
+    bpf::fsize count = 0;
+    for (auto &log : logs)
+    {
+        if (log.EndsWith("circular dependency detected"))
+            ++count;
+    }
+    EXPECT_EQ(count, 2u);
+}
+
+class SlowMountBuilder final : public SimpleAsset
+{
+public:
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        bpf::system::Thread::Sleep(10); //Simulate an expensive driver upload
+        return (bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), vpath));
+    }
+};
+
+class SlowMountProvider final : public IAssetProvider
+{
+public:
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<SlowMountBuilder>());
+    }
+};
+
+TEST(AssetManager, Poll_Budget)
+{
+    AssetManager manager;
+    bpf::fsize total = 0;
+    PollStats stats;
+
+    manager.SetProvider<Asset>("slow", bpf::memory::MakeUnique<SlowMountProvider>());
+    for (bpf::fsize i = 0; i != 4; ++i)
+        manager.Add(bpf::String::Format("Test/Slow/[]", i), "bp3d::Asset/slow,%Assets%/slow.null");
+    EXPECT_EQ(manager.GetPendingCount(), 4u);
+    while (total < 4)
+    {
+        stats = manager.Poll(std::chrono::microseconds(1));
+        EXPECT_LE(stats.Mounted, 1u); //The budget is always exceeded by the first mount
+        total += stats.Mounted;
+    }
+    EXPECT_EQ(stats.Pending, 0u);
+    for (bpf::fsize i = 0; i != 4; ++i)
+        EXPECT_NE(manager.Get<Asset>(bpf::Name(bpf::String::Format("Test/Slow/[]", i))), nullptr);
+}
+
+TEST(AssetManager, Wait_Timeout)
+{
+    AssetManager manager;
+
+    manager.SetProvider<Asset>("slow", bpf::memory::MakeUnique<SlowMountProvider>());
+    for (bpf::fsize i = 0; i != 40; ++i)
+        manager.Add(bpf::String::Format("Test/Slow/[]", i), "bp3d::Asset/slow,%Assets%/slow.null");
+    auto last = manager.GetHandle<Asset>(bpf::Name("Test/Slow/39"));
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_FALSE(manager.Wait(last, std::chrono::milliseconds(30))); //Mounting everything takes 400 ms
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(200));
+    EXPECT_TRUE(manager.Wait(last, std::chrono::seconds(5)));
+}
+
+TEST(AssetManager, Priority)
+{
+    bpf::collection::List<bpf::String> logs;
+    AssetManager manager(1);
+
+    manager.SetProvider<Asset>("null", bpf::memory::MakeUnique<SuperProvider>(bpf::system::Paths(bpf::io::File(), bpf::io::File(), bpf::io::File(), bpf::io::File()), false));
+    manager.AddLogHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    manager.Add("Test/Blocker", "bp3d::Asset/null,%Assets%/blocker.null");
+    bpf::system::Thread::Sleep(20); //Make sure the only worker is busy with the blocker
+    manager.Add("Test/Low1", "bp3d::Asset/null,%Assets%/low.null", EAssetPriority::LOW);
+    manager.Add("Test/Low2", "bp3d::Asset/null,%Assets%/low.null", EAssetPriority::LOW);
+    manager.Add("Test/Critical", "bp3d::Asset/null,%Assets%/critical.null", EAssetPriority::CRITICAL);
+    EXPECT_TRUE(manager.SetPriority(bpf::Name("Test/Low2"), EAssetPriority::HIGH));
+    EXPECT_FALSE(manager.SetPriority(bpf::Name("Test/Unknown"), EAssetPriority::HIGH));
+    manager.WaitForAllObjects();
+    bpf::collection::List<bpf::String> loaded;
+    for (auto &log : logs)
+    {
+        if (log.StartsWith("[INFO]AssetManager> Successfully loaded asset"))
+            loaded.Add(log);
+    }
+    ASSERT_EQ(loaded.Size(), 4u);
+    EXPECT_STREQ(*loaded[0], "[INFO]AssetManager> Successfully loaded asset 'Test/Blocker'");
+    EXPECT_STREQ(*loaded[1], "[INFO]AssetManager> Successfully loaded asset 'Test/Critical'");
+    EXPECT_STREQ(*loaded[2], "[INFO]AssetManager> Successfully loaded asset 'Test/Low2'");
+    EXPECT_STREQ(*loaded[3], "[INFO]AssetManager> Successfully loaded asset 'Test/Low1'");
+}
+
+TEST(AssetManager, AddBatch)
+{
+    bpf::collection::List<bpf::String> logs;
+    AssetManager manager;
+    bpf::collection::ArrayList<bpf::Tuple<bpf::String, bpf::String>> batch;
+
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    manager.AddLogHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    batch.Add(bpf::Tuple<bpf::String, bpf::String>("Test/A", "bp3d::Asset/dep,Test/B"));
+    batch.Add(bpf::Tuple<bpf::String, bpf::String>("Test/B", "bp3d::Asset/dep,none"));
+    batch.Add(bpf::Tuple<bpf::String, bpf::String>("Test/Invalid", "invalid"));
+    batch.Add(bpf::Tuple<bpf::String, bpf::String>("Test/C", "bp3d::Asset/dep,none"));
+    auto handles = manager.AddBatch(batch);
+    EXPECT_STREQ(*logs[0], "[INFO]AssetManager> Loading 4 assets...");
+    EXPECT_STREQ(*logs[1], "[ERROR]AssetManager> Could not load asset 'Test/Invalid': incorrect asset url format");
+    ASSERT_EQ(handles.Size(), 4u);
+    EXPECT_TRUE(handles[0].IsValid());
+    EXPECT_TRUE(handles[1].IsValid());
+    EXPECT_FALSE(handles[2].IsValid()); //Rejected urls keep their place in the list
+    EXPECT_TRUE(handles[3].IsValid());
+    manager.WaitForAllObjects();
+    EXPECT_EQ(manager.GetHandle<Asset>(bpf::Name("Test/A")), handles[0]);
+    EXPECT_EQ(manager.GetHandle<Asset>(bpf::Name("Test/B")), handles[1]);
+    EXPECT_EQ(manager.GetHandle<Asset>(bpf::Name("Test/C")), handles[3]);
+    EXPECT_STREQ(*manager.Get<Asset>(handles[0])->VirtualPath(), "Test/A");
+    EXPECT_STREQ(*manager.Get<Asset>(handles[1])->VirtualPath(), "Test/B");
+    EXPECT_STREQ(*manager.Get<Asset>(handles[3])->VirtualPath(), "Test/C");
+    EXPECT_EQ(manager.Get<Asset>(handles[2]), nullptr);
+    EXPECT_EQ(manager.Get<Asset>(bpf::Name("Test/Invalid")), nullptr);
+}
+
+TEST(AssetManager, Handle)
+{
+    AssetManager manager;
+
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    auto a = manager.Add<Asset>("Test/A", "bp3d::Asset/dep,none");
+    auto invalid = manager.Add<Asset>("Test/Invalid", "invalid");
+    EXPECT_TRUE(a.IsValid());
+    EXPECT_FALSE(invalid.IsValid());
+    EXPECT_EQ(manager.Get<Asset>(a), nullptr); //Not yet mounted
+    manager.WaitForAllObjects();
+    EXPECT_NE(manager.Get<Asset>(a), nullptr);
+    EXPECT_EQ(manager.Get<Asset>(a), manager.Get<Asset>(bpf::Name("Test/A")));
+    EXPECT_EQ(manager.GetHandle<Asset>(bpf::Name("Test/A")), a);
+    EXPECT_EQ(manager.Get<Asset>(invalid), nullptr);
+    auto def = manager.Add<Asset>(bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), "Test/Default"));
+    manager.SetDefault<Asset>(bpf::Name("Test/Default"));
+    EXPECT_EQ(manager.GetDefault<Asset>(), manager.Get<Asset>(def));
+    manager.Remove("Test/A");
+    EXPECT_EQ(manager.Get<Asset>(a), manager.Get<Asset>(def)); //Stale handles resolve to the default
+    auto b = manager.Add<Asset>(bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), "Test/B"));
+    EXPECT_EQ(b.Index(), a.Index()); //The slot is reused with a new generation
+    EXPECT_NE(b.Generation(), a.Generation());
+    EXPECT_EQ(manager.Get<Asset>(a), manager.Get<Asset>(def));
+    EXPECT_STREQ(*manager.Get<Asset>(b)->VirtualPath(), "Test/B");
+    manager.Remove("Test/*");
+    EXPECT_EQ(manager.Get<Asset>(b), nullptr);
+}
+
+TEST(AssetManager, ForEach_Remove)
+{
+    bpf::collection::List<bpf::String> logs;
+    AssetManager manager;
+    bpf::fsize count = 0;
+
+    manager.AddLogHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    manager.Add<Asset>(bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), "Level1/A"));
+    manager.Add<Asset>(bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), "Level1/B"));
+    manager.Add<Asset>(bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), "Level2/A"));
+    manager.ForEach("Level1/", [&](Asset &asset) {
+        EXPECT_TRUE(asset.VirtualPath().StartsWith("Level1/"));
+        ++count;
+    });
+    EXPECT_EQ(count, 2u);
+    manager.Remove("Level1/*");
+    EXPECT_EQ(logs.Size(), 2u);
+    EXPECT_EQ(manager.Get<Asset>(bpf::Name("Level1/A")), nullptr);
+    EXPECT_EQ(manager.Get<Asset>(bpf::Name("Level1/B")), nullptr);
+    EXPECT_NE(manager.Get<Asset>(bpf::Name("Level2/A")), nullptr);
+    count = 0;
+    manager.ForEach("", [&](Asset &) { ++count; });
+    EXPECT_EQ(count, 1u);
+}
+
+class SizedAsset final : public Asset
+{
+public:
+    explicit SizedAsset(const bpf::String &vpath)
+        : Asset(bpf::Name(bpf::TypeName<Asset>()), vpath)
+    {
+    }
+
+    bpf::fsize GetCPUSize() const noexcept final
+    {
+        return (100);
+    }
+};
+
+class SizedBuilder final : public SimpleAsset
+{
+public:
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        return (bpf::memory::MakeUnique<SizedAsset>(vpath));
+    }
+};
+
+class SizedProvider final : public IAssetProvider
+{
+public:
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<SizedBuilder>());
+    }
+};
+
+TEST(AssetManager, Budget)
+{
+    AssetManager manager;
+
+    manager.SetProvider<Asset>("sized", bpf::memory::MakeUnique<SizedProvider>());
+    auto a = manager.Add<Asset>("Test/A", "bp3d::Asset/sized,none");
+    auto b = manager.Add<Asset>("Test/B", "bp3d::Asset/sized,none");
+    auto c = manager.Add<Asset>("Test/C", "bp3d::Asset/sized,none");
+    manager.WaitForAllObjects();
+    EXPECT_EQ(manager.GetCPUUsage(), 300u);
+    manager.Get<Asset>(a)->AddUse();
+    manager.Get<Asset>(b);
+    manager.Get<Asset>(c);
+    manager.SetMemoryBudget(250, 0);
+    //A is the least recently used asset but it is in use, B is the next one
+    EXPECT_EQ(manager.GetCPUUsage(), 200u);
+    EXPECT_NE(manager.Get<Asset>(a), nullptr);
+    EXPECT_NE(manager.Get<Asset>(c), nullptr);
+    EXPECT_EQ(manager.Get<Asset>(b), nullptr); //Evicted, this requests a reload
+    manager.Get<Asset>(a)->RemoveUse();
+    manager.Get<Asset>(c);
+    manager.WaitForAllObjects();
+    //B is back and A, now unused and least recently used, made room for it
+    EXPECT_EQ(manager.GetCPUUsage(), 200u);
+    EXPECT_NE(manager.Get<Asset>(b), nullptr);
+    EXPECT_STREQ(*manager.Get<Asset>(b)->VirtualPath(), "Test/B");
+    EXPECT_NE(manager.Get<Asset>(c), nullptr);
+    manager.SetDefault<Asset>(bpf::Name("Test/C"));
+    EXPECT_EQ(manager.Get<Asset>(a), manager.Get<Asset>(c)); //Evicted entries fall back to the default
+}
+
+class HotReloadBuilder final : public IAssetBuilder
+{
+private:
+    bpf::collection::List<bpf::Tuple<bpf::String, bpf::String>> _emptyExpanded;
+    bpf::collection::List<bpf::Name> _dependencies;
+
+public:
+    explicit HotReloadBuilder(const bpf::String &dependency)
+    {
+        if (dependency != bpf::String::Empty)
+            _dependencies.Add(bpf::Name(dependency));
+    }
+
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    inline const bpf::collection::List<bpf::Tuple<bpf::String, bpf::String>> &GetExpandedAssets() const noexcept final
+    {
+        return (_emptyExpanded);
+    }
+
+    inline const bpf::collection::List<bpf::Name> &GetDependencies() const noexcept final
+    {
+        return (_dependencies);
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        return (bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), vpath));
+    }
+};
+
+class HotReloadProvider final : public IAssetProvider
+{
+private:
+    bpf::String _dependency;
+
+public:
+    explicit HotReloadProvider(const bpf::String &dependency)
+        : _dependency(dependency)
+    {
+    }
+
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<HotReloadBuilder>(_dependency));
+    }
+};
+
+static void WriteTestFile(const bpf::io::File &file, const bpf::String &content)
+{
+    bpf::io::FileStream stream(file, bpf::io::FILE_MODE_WRITE | bpf::io::FILE_MODE_TRUNCATE);
+    stream.Write(*content, content.Size());
+}
+
+static bpf::fsize CountLines(const bpf::collection::List<bpf::String> &logs, const bpf::String &line)
+{
+    bpf::fsize count = 0;
+
+    for (auto &log : logs)
+    {
+        if (log == line)
+            ++count;
+    }
+    return (count);
+}
+
+TEST(AssetManager, HotReload)
+{
+    bpf::collection::List<bpf::String> logs;
+    AssetManager manager;
+    bpf::system::Paths paths(bpf::io::File("."), bpf::io::File(), bpf::io::File(), bpf::io::File());
+
+    if (!manager.EnableHotReload(paths))
+        return;
+    manager.SetProvider<Asset>("hot", bpf::memory::MakeUnique<HotReloadProvider>(bpf::String::Empty));
+    manager.SetProvider<Asset>("hotdep", bpf::memory::MakeUnique<HotReloadProvider>("Test/HotA"));
+    manager.AddLogHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    WriteTestFile(bpf::io::File("./HotReload_A.txt"), "A");
+    WriteTestFile(bpf::io::File("./HotReload_B.txt"), "B");
+    WriteTestFile(bpf::io::File("./HotReload_C.txt"), "C");
+    manager.Add("Test/HotA", "bp3d::Asset/hot,%App%/HotReload_A.txt");
+    manager.Add("Test/HotB", "bp3d::Asset/hotdep,%App%/HotReload_B.txt");
+    manager.Add("Test/HotC", "bp3d::Asset/hot,%App%/HotReload_C.txt");
+    manager.WaitForAllObjects();
+    auto b = manager.GetHandle<Asset>(bpf::Name("Test/HotB"));
+    WriteTestFile(bpf::io::File("./HotReload_A.txt"), "A2");
+    for (int i = 0; i != 500 && CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotB'") < 2; ++i)
+    {
+        manager.Poll();
+        bpf::system::Thread::Sleep(10);
+    }
+    manager.WaitForAllObjects();
+    EXPECT_EQ(CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotA'"), 2u);
+    EXPECT_EQ(CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotB'"), 2u);
+    EXPECT_EQ(CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotC'"), 1u);
+    EXPECT_NE(manager.Get<Asset>(b), nullptr); //Handles survive the swap
+    bpf::io::File("./HotReload_A.txt").Delete();
+    bpf::io::File("./HotReload_B.txt").Delete();
+    bpf::io::File("./HotReload_C.txt").Delete();
+}
+
+TEST(AssetManager, HotReload_Forget)
+{
+    bpf::collection::List<bpf::String> logs;
+    AssetManager manager;
+    bpf::system::Paths paths(bpf::io::File("."), bpf::io::File(), bpf::io::File(), bpf::io::File());
+
+    if (!manager.EnableHotReload(paths))
+        return;
+    manager.SetProvider<Asset>("hot", bpf::memory::MakeUnique<HotReloadProvider>(bpf::String::Empty));
+    manager.SetProvider<Asset>("hotdep", bpf::memory::MakeUnique<HotReloadProvider>("Test/HotA"));
+    manager.AddLogHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    WriteTestFile(bpf::io::File("./HotReload_E.txt"), "E");
+    WriteTestFile(bpf::io::File("./HotReload_F.txt"), "F");
+    manager.Add("Test/HotA", "bp3d::Asset/hot,%App%/HotReload_E.txt");
+    manager.Add("Test/HotB", "bp3d::Asset/hotdep,%App%/HotReload_F.txt");
+    manager.WaitForAllObjects();
+    //Added again without the dependency: changes to Test/HotA must no longer rebuild it
+    manager.Remove("Test/HotB");
+    manager.Add("Test/HotB", "bp3d::Asset/hot,%App%/HotReload_F.txt");
+    manager.WaitForAllObjects();
+    WriteTestFile(bpf::io::File("./HotReload_E.txt"), "E2");
+    for (int i = 0; i != 500 && CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotA'") < 2; ++i)
+    {
+        manager.Poll();
+        bpf::system::Thread::Sleep(10);
+    }
+    manager.WaitForAllObjects();
+    EXPECT_EQ(CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotA'"), 2u);
+    EXPECT_EQ(CountLines(logs, "[INFO]AssetManager> Reloading asset 'Test/HotB'..."), 0u);
+    bpf::io::File("./HotReload_E.txt").Delete();
+    bpf::io::File("./HotReload_F.txt").Delete();
+}
+
+class CancellableBuilder final : public SimpleAsset
+{
+private:
+    std::atomic<int> &_cancelled;
+
+public:
+    explicit CancellableBuilder(std::atomic<int> &cancelled)
+        : _cancelled(cancelled)
+    {
+    }
+
+    void Build(const CancellationToken &token) final
+    {
+        for (int i = 0; i != 5000; ++i)
+        {
+            if (token.IsCancelled())
+            {
+                ++_cancelled;
+                return;
+            }
+            bpf::system::Thread::Sleep(1);
+        }
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        return (bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), vpath));
+    }
+};
+
+class CancellableProvider final : public IAssetProvider
+{
+private:
+    std::atomic<int> &_cancelled;
+
+public:
+    explicit CancellableProvider(std::atomic<int> &cancelled)
+        : _cancelled(cancelled)
+    {
+    }
+
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<CancellableBuilder>(_cancelled));
+    }
+};
+
+TEST(AssetManager, Remove_Cancel)
+{
+    std::atomic<int> cancelled(0);
+    AssetManager manager(1);
+
+    manager.SetProvider<Asset>("slow", bpf::memory::MakeUnique<CancellableProvider>(cancelled));
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    manager.Add("Level/A", "bp3d::Asset/slow,none");
+    manager.Add("Level/B", "bp3d::Asset/slow,none");
+    manager.Add("Level/C", "bp3d::Asset/slow,none");
+    manager.Add("Other/A", "bp3d::Asset/dep,none");
+    bpf::system::Thread::Sleep(50); //Let the only worker start building Level/A
+    auto start = std::chrono::steady_clock::now();
+    manager.Remove("Level/*");
+    manager.WaitForAllObjects();
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(4));
+    EXPECT_LE(cancelled, 1); //Only the running build sees its token set, the queued ones never start
+    EXPECT_EQ(manager.Get<Asset>(bpf::Name("Level/A")), nullptr);
+    EXPECT_EQ(manager.Get<Asset>(bpf::Name("Level/B")), nullptr);
+    EXPECT_EQ(manager.Get<Asset>(bpf::Name("Level/C")), nullptr);
+    EXPECT_NE(manager.Get<Asset>(bpf::Name("Other/A")), nullptr);
+    EXPECT_EQ(manager.GetPendingCount(), 0u);
+}
+
+class DelayedBuilder final : public SimpleAsset
+{
+private:
+    bpf::uint32 _delay;
+
+public:
+    explicit DelayedBuilder(bpf::uint32 delay)
+        : _delay(delay)
+    {
+    }
+
+    void Build(const CancellationToken &) final
+    {
+        bpf::system::Thread::Sleep(_delay);
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        return (bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), vpath));
+    }
+};
+
+class DelayedProvider final : public IAssetProvider
+{
+private:
+    bpf::uint32 _delay;
+
+public:
+    explicit DelayedProvider(bpf::uint32 delay)
+        : _delay(delay)
+    {
+    }
+
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<DelayedBuilder>(_delay));
+    }
+};
+
+TEST(AssetManager, Remove_Dependent)
+{
+    AssetManager manager(4);
+
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    manager.SetProvider<Asset>("fast", bpf::memory::MakeUnique<DelayedProvider>(100));
+    manager.SetProvider<Asset>("slow", bpf::memory::MakeUnique<DelayedProvider>(600));
+    manager.Add("Test/B", "bp3d::Asset/fast,none");
+    manager.Add("Test/C", "bp3d::Asset/slow,none");
+    manager.Add("Test/A", "bp3d::Asset/dep,Test/B;Test/C");
+    for (int i = 0; i != 20; ++i) //Let Test/A build and wait on its dependencies
+    {
+        manager.Poll();
+        bpf::system::Thread::Sleep(1);
+    }
+    manager.Remove("Test/A");
+    auto a = manager.Add("Test/A", "bp3d::Asset/dep,Test/B;Test/C");
+    //DependencyBuilder::Mount checks that both dependencies are mounted
+    while (manager.GetState(a) == EAssetState::PENDING)
+    {
+        manager.Poll();
+        bpf::system::Thread::Sleep(1);
+        if (manager.GetState(a) == EAssetState::MOUNTED)
+        {
+            EXPECT_NE(manager.Get<Asset>(bpf::Name("Test/C")), nullptr);
+        }
+    }
+    EXPECT_EQ(manager.GetState(a), EAssetState::MOUNTED);
+}
+
+TEST(AssetManager, Remove_Mountable)
+{
+    AssetManager manager;
+    int calls = 0;
+
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    manager.SetProvider<Asset>("slow", bpf::memory::MakeUnique<DelayedProvider>(300));
+    manager.Add("Test/A", "bp3d::Asset/dep,none");
+    manager.Add("Test/B", "bp3d::Asset/dep,none");
+    bpf::system::Thread::Sleep(100); //Lets both entries build
+    EXPECT_TRUE(manager.Poll(1));
+    EXPECT_EQ(manager.GetState(manager.GetHandle<Asset>(bpf::Name("Test/A"))), EAssetState::MOUNTED);
+    //The built entry of the removed asset must not be mounted for the asset added again
+    manager.Remove("Test/B");
+    auto b = manager.Add("Test/B", "bp3d::Asset/slow,none");
+    manager.Then(b, [&](Asset *) { ++calls; });
+    manager.Poll(1);
+    EXPECT_EQ(manager.GetState(b), EAssetState::PENDING);
+    EXPECT_EQ(calls, 0);
+    EXPECT_TRUE(manager.Wait(b, std::chrono::seconds(5)));
+    EXPECT_EQ(manager.GetState(b), EAssetState::MOUNTED);
+    EXPECT_EQ(calls, 1);
+}
+
+TEST(AssetManager, HotReload_ChangedAgain)
+{
+    bpf::collection::List<bpf::String> logs;
+    AssetManager manager;
+    bpf::system::Paths paths(bpf::io::File("."), bpf::io::File(), bpf::io::File(), bpf::io::File());
+
+    if (!manager.EnableHotReload(paths))
+        return;
+    manager.SetProvider<Asset>("slow", bpf::memory::MakeUnique<DelayedProvider>(300));
+    manager.AddLogHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    WriteTestFile(bpf::io::File("./HotReload_D.txt"), "D");
+    manager.Add("Test/HotD", "bp3d::Asset/slow,%App%/HotReload_D.txt");
+    manager.WaitForAllObjects();
+    WriteTestFile(bpf::io::File("./HotReload_D.txt"), "D2");
+    for (int i = 0; i != 500 && CountLines(logs, "[INFO]AssetManager> Reloading asset 'Test/HotD'...") < 1; ++i)
+    {
+        manager.Poll();
+        bpf::system::Thread::Sleep(10);
+    }
+    //Changed while the first reload is building: a second reload must follow
+    WriteTestFile(bpf::io::File("./HotReload_D.txt"), "D3");
+    for (int i = 0; i != 500 && CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotD'") < 3; ++i)
+    {
+        manager.Poll();
+        bpf::system::Thread::Sleep(10);
+    }
+    EXPECT_EQ(CountLines(logs, "[INFO]AssetManager> Reloading asset 'Test/HotD'..."), 2u);
+    EXPECT_EQ(CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotD'"), 3u);
+    //The file is watched again after being removed and added back
+    manager.Remove("Test/HotD");
+    manager.Add("Test/HotD", "bp3d::Asset/slow,%App%/HotReload_D.txt");
+    manager.WaitForAllObjects();
+    WriteTestFile(bpf::io::File("./HotReload_D.txt"), "D4");
+    for (int i = 0; i != 500 && CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotD'") < 5; ++i)
+    {
+        manager.Poll();
+        bpf::system::Thread::Sleep(10);
+    }
+    EXPECT_EQ(CountLines(logs, "[INFO]AssetManager> Successfully loaded asset 'Test/HotD'"), 5u);
+    bpf::io::File("./HotReload_D.txt").Delete();
+}
+
+TEST(AssetManager, Wait_Then)
+{
+    AssetManager manager;
+    bpf::collection::ArrayList<bpf::String> mounted;
+    int failures = 0;
+
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    auto a = manager.Add<Asset>("Test/A", "bp3d::Asset/dep,Test/B");
+    auto b = manager.Add<Asset>("Test/B", "bp3d::Asset/dep,none");
+    auto missing = manager.Add<Asset>("Test/Missing", "bp3d::Asset/dep,Test/None");
+    auto invalid = manager.Add<Asset>("Test/Invalid", "invalid");
+    manager.Then(a, [&](Asset *asset) { mounted.Add(asset->VirtualPath()); });
+    manager.Then(missing, [&](Asset *asset) { failures += asset == nullptr ? 1 : 0; });
+    manager.Then(invalid, [&](Asset *asset) { failures += asset == nullptr ? 1 : 0; });
+    EXPECT_EQ(failures, 1); //Invalid handles fail immediately
+    EXPECT_EQ(manager.GetState(a), EAssetState::PENDING);
+    EXPECT_EQ(manager.GetState(invalid), EAssetState::FAILED);
+    EXPECT_TRUE(manager.Wait(a, std::chrono::seconds(5)));
+    EXPECT_EQ(manager.GetState(a), EAssetState::MOUNTED);
+    EXPECT_EQ(manager.GetState(b), EAssetState::MOUNTED);
+    ASSERT_EQ(mounted.Size(), 1u);
+    EXPECT_STREQ(*mounted[0], "Test/A");
+    bpf::collection::ArrayList<AssetHandle<Asset>> handles;
+    handles.Add(missing);
+    EXPECT_TRUE(manager.Wait(handles, std::chrono::seconds(5)));
+    EXPECT_EQ(manager.GetState(missing), EAssetState::FAILED);
+    EXPECT_EQ(failures, 2);
+    manager.Then(b, [&](Asset *asset) { mounted.Add(asset->VirtualPath()); }); //Already mounted: runs immediately
+    EXPECT_EQ(mounted.Size(), 2u);
+    auto token = std::unique_ptr<int>(new int(3));
+    manager.Then(b, [token = std::move(token), &failures](Asset *) { failures += *token; }); //Move-only functions are accepted
+    EXPECT_EQ(failures, 5);
+    auto never = manager.GetHandle<Asset>(bpf::Name("Test/Never"));
+    EXPECT_FALSE(manager.Wait(never, std::chrono::milliseconds(10)));
+    manager.Remove("Test/A");
+    EXPECT_EQ(manager.GetState(a), EAssetState::FAILED);
+}
+
+struct StagedTrace
+{
+    std::atomic<int> Computed;
+    std::atomic<int> SameThread;
+};
+
+class TestStagedBuilder final : public StagedAsset
+{
+private:
+    StagedTrace &_trace;
+    std::thread::id _reader;
+    bpf::uint8 _sum;
+
+public:
+    explicit TestStagedBuilder(StagedTrace &trace)
+        : _trace(trace)
+        , _sum(0)
+    {
+    }
+
+    void Read(const CancellationToken &, bpf::collection::ArrayList<bpf::io::ByteBuf> &buffers) final
+    {
+        bpf::io::ByteBuf buf(4);
+
+        for (bpf::uint8 i = 1; i != 5; ++i)
+            buf.Write(&i, 1);
+        buffers.Add(std::move(buf));
+        _reader = std::this_thread::get_id();
+    }
+
+    void Compute(const CancellationToken &, bpf::collection::ArrayList<bpf::io::ByteBuf> &buffers) final
+    {
+        for (auto &buf : buffers)
+        {
+            for (bpf::fsize i = 0; i != buf.Size(); ++i)
+                _sum += buf[i];
+        }
+        if (_reader == std::this_thread::get_id())
+            ++_trace.SameThread;
+        ++_trace.Computed;
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        if (_sum != 10)
+            return (nullptr);
+        return (bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), vpath));
+    }
+};
+
+class StagedProvider final : public IAssetProvider
+{
+private:
+    StagedTrace &_trace;
+
+public:
+    explicit StagedProvider(StagedTrace &trace)
+        : _trace(trace)
+    {
+    }
+
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<TestStagedBuilder>(_trace));
+    }
+};
+
+TEST(AssetManager, Staged)
+{
+    StagedTrace trace;
+    trace.Computed = 0;
+    trace.SameThread = 0;
+    AssetManager manager(2, 1);
+
+    manager.SetProvider<Asset>("staged", bpf::memory::MakeUnique<StagedProvider>(trace));
+    manager.SetProvider<Asset>("dep", bpf::memory::MakeUnique<DependencyProvider>());
+    for (int i = 0; i != 16; ++i)
+        manager.Add(bpf::String::Format("Staged/[]", i), "bp3d::Asset/staged,none");
+    manager.Add("Other/A", "bp3d::Asset/dep,none");
+    manager.WaitForAllObjects();
+    EXPECT_EQ(trace.Computed, 16);
+    EXPECT_EQ(trace.SameThread, 0); //Read runs on the IO worker, Compute on a build worker
+    for (int i = 0; i != 16; ++i)
+        EXPECT_NE(manager.Get<Asset>(bpf::Name(bpf::String::Format("Staged/[]", i))), nullptr);
+    EXPECT_NE(manager.Get<Asset>(bpf::Name("Other/A")), nullptr);
+}
+
+class CachedBuilder final : public SimpleAsset
+{
+private:
+    std::atomic<int> &_builds;
+    bpf::uint32 _version;
+    bpf::uint32 _value;
+
+public:
+    CachedBuilder(std::atomic<int> &builds, bpf::uint32 version)
+        : _builds(builds)
+        , _version(version)
+        , _value(0)
+    {
+    }
+
+    void Build(const CancellationToken &) final
+    {
+        ++_builds;
+        _value = 42;
+    }
+
+    bpf::uint32 GetCacheVersion() const noexcept final
+    {
+        return (_version);
+    }
+
+    bpf::io::ByteBuf Serialize() const final
+    {
+        bpf::io::ByteBuf blob(sizeof(_value));
+        blob.Write(&_value, sizeof(_value));
+        return (blob);
+    }
+
+    bool Deserialize(bpf::io::ByteBuf &blob) final
+    {
+        return (blob.Read(&_value, sizeof(_value)) == sizeof(_value));
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        if (_value != 42)
+            return (nullptr);
+        return (bpf::memory::MakeUnique<Asset>(bpf::Name(bpf::TypeName<Asset>()), vpath));
+    }
+};
+
+class CachedProvider final : public IAssetProvider
+{
+private:
+    std::atomic<int> &_builds;
+    bpf::uint32 _version;
+
+public:
+    CachedProvider(std::atomic<int> &builds, bpf::uint32 version)
+        : _builds(builds)
+        , _version(version)
+    {
+    }
+
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<CachedBuilder>(_builds, _version));
+    }
+};
+
+static void LoadCached(const bpf::system::Paths &paths, std::atomic<int> &builds, bpf::uint32 version)
+{
+    AssetManager manager;
+
+    EXPECT_TRUE(manager.EnableBuildCache(paths));
+    manager.SetProvider<Asset>("cached", bpf::memory::MakeUnique<CachedProvider>(builds, version));
+    manager.Add("Test/Cached", "bp3d::Asset/cached,%App%/BuildCache_A.txt");
+    manager.WaitForAllObjects();
+    EXPECT_NE(manager.Get<Asset>(bpf::Name("Test/Cached")), nullptr);
+}
+
+TEST(AssetManager, BuildCache)
+{
+    std::atomic<int> builds(0);
+    bpf::system::Paths paths(bpf::io::File("."), bpf::io::File(), bpf::io::File(), bpf::io::File("./BuildCache"));
+    AssetBuildCache cache(paths);
+    bpf::collection::ArrayList<bpf::io::File> blobs;
+    bpf::uint64 hash;
+
+    WriteTestFile(bpf::io::File("./BuildCache_A.txt"), "A");
+    LoadCached(paths, builds, 1);
+    EXPECT_EQ(builds, 1);
+    LoadCached(paths, builds, 1); //Restored from the cache
+    EXPECT_EQ(builds, 1);
+    ASSERT_TRUE(AssetBuildCache::HashFile(bpf::io::File("./BuildCache_A.txt"), hash));
+    blobs.Add(cache.GetBlobPath("bp3d::Asset/cached", hash, 1));
+    EXPECT_TRUE(blobs[0].Exists());
+    WriteTestFile(bpf::io::File("./BuildCache_A.txt"), "A2");
+    LoadCached(paths, builds, 1); //Source changed
+    EXPECT_EQ(builds, 2);
+    LoadCached(paths, builds, 2); //Builder version changed
+    EXPECT_EQ(builds, 3);
+    LoadCached(paths, builds, 2);
+    EXPECT_EQ(builds, 3);
+    ASSERT_TRUE(AssetBuildCache::HashFile(bpf::io::File("./BuildCache_A.txt"), hash));
+    blobs.Add(cache.GetBlobPath("bp3d::Asset/cached", hash, 1));
+    blobs.Add(cache.GetBlobPath("bp3d::Asset/cached", hash, 2));
+    for (auto &blob : blobs)
+        EXPECT_TRUE(blob.Delete());
+    bpf::io::File("./BuildCache/Assets").Delete();
+    bpf::io::File("./BuildCache").Delete();
+    bpf::io::File("./BuildCache_A.txt").Delete();
+}
+
+TEST(AssetManager, LoadStats)
+{
+    AssetManager manager(1);
+    bpf::fsize mounted = 0;
+    bpf::uint64 mountMicros = 0;
+
+    manager.SetProvider<Asset>("null", bpf::memory::MakeUnique<SuperProvider>(bpf::system::Paths(bpf::io::File(), bpf::io::File(), bpf::io::File(), bpf::io::File()), false));
+    manager.SetProvider<Asset>("slow", bpf::memory::MakeUnique<SlowMountProvider>());
+    auto null = manager.Add("Test/Null", "bp3d::Asset/null,%Assets%/test.null");
+    auto slow = manager.Add("Test/Slow", "bp3d::Asset/slow,%Assets%/slow.null");
+    while (mounted < 3)
+    {
+        auto stats = manager.Poll(std::chrono::microseconds(100000));
+        mounted += stats.Mounted;
+        mountMicros += stats.Timings.MountMicros;
+    }
+    EXPECT_GE(mountMicros, 10000u);
+    EXPECT_GE(manager.GetLoadTimings(null).BuildMicros, 100000u);
+    EXPECT_GE(manager.GetLoadTimings(slow).QueueWaitMicros, 50000u); //The only worker was building Test/Null, which may have started before Test/Slow was queued
+    EXPECT_GE(manager.GetLoadTimings(slow).MountMicros, 10000u);
+    EXPECT_EQ(manager.GetLoadTimings(AssetHandle<Asset>()).BuildMicros, 0u);
+    const auto &stats = manager.GetLoadStats();
+    EXPECT_EQ(stats.GetCount(), 3u);
+    auto format = stats.GetFormat(bpf::Name("bp3d::Asset/null"));
+    ASSERT_NE(format, nullptr);
+    EXPECT_STREQ(*format->Format, "bp3d::Asset/null");
+    EXPECT_EQ(format->Build.GetCount(), 2u); //Test/Null and its expanded asset
+    EXPECT_GE(format->Build.GetPercentileMicros(50), 65536u); //Both builds fall in the [2^16, 2^17) bucket or above
+    EXPECT_EQ(stats.GetFormat(bpf::Name("bp3d::Asset/slow"))->Mount.GetCount(), 1u);
+    EXPECT_EQ(stats.GetFormat(bpf::Name("bp3d::Asset/none")), nullptr);
+    manager.ResetLoadStats();
+    EXPECT_EQ(manager.GetLoadStats().GetCount(), 0u);
+}
+
+TEST(AssetManager, Tracing)
+{
+    bpf::io::File file("./AssetManager_Trace.json");
+    {
+        AssetManager manager(1);
+        manager.SetProvider<Asset>("null", bpf::memory::MakeUnique<SuperProvider>(bpf::system::Paths(bpf::io::File(), bpf::io::File(), bpf::io::File(), bpf::io::File()), false));
+        ASSERT_TRUE(manager.EnableTracing(file));
+        manager.Add("Test/Null", "bp3d::Asset/null,%Assets%/test.null");
+        manager.WaitForAllObjects();
+        manager.FlushTrace();
+        bpf::io::FileStream stream(file, bpf::io::FILE_MODE_READ);
+        bpf::io::ByteBuf buf(file.GetSizeBytes());
+        bpf::String text;
+        stream.Read(*buf, buf.Size());
+        for (bpf::fsize i = 0; i != buf.Size(); ++i)
+            text += static_cast<char>(buf[i]);
+        EXPECT_NE(text.IndexOf("\"name\":\"Build\""), -1);
+        EXPECT_NE(text.IndexOf("\"name\":\"Mount\""), -1);
+        EXPECT_NE(text.IndexOf("\"name\":\"DependencyWait\""), -1);
+        EXPECT_NE(text.IndexOf("\"name\":\"Building\""), -1);
+        EXPECT_NE(text.IndexOf("{\"asset\":\"Test/Null\"}"), -1);
+    }
+    EXPECT_TRUE(file.Delete());
+}
+
+class ProgressiveAsset final : public Asset
+{
+public:
+    int Level;
+
+    explicit ProgressiveAsset(const bpf::String &vpath)
+        : Asset(bpf::Name(bpf::TypeName<Asset>()), vpath)
+        , Level(0)
+    {
+    }
+
+    bpf::fsize GetCPUSize() const noexcept final
+    {
+        return (static_cast<bpf::fsize>(Level + 1) * 100);
+    }
+};
+
+class ProgressiveBuilder final : public SimpleAsset
+{
+private:
+    int _level;
+    int _maxLevel;
+
+public:
+    explicit ProgressiveBuilder(int maxLevel)
+        : _level(0)
+        , _maxLevel(maxLevel)
+    {
+    }
+
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    bool HasRefinement() const noexcept final
+    {
+        return (_level < _maxLevel);
+    }
+
+    void Refine(const CancellationToken &) final
+    {
+        bpf::system::Thread::Sleep(5); //Simulate streaming the next mip level
+        ++_level;
+    }
+
+    void Apply(AssetManager &, Asset &asset) final
+    {
+        EXPECT_EQ(static_cast<ProgressiveAsset &>(asset).Level + 1, _level);
+        static_cast<ProgressiveAsset &>(asset).Level = _level;
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        return (bpf::memory::MakeUnique<ProgressiveAsset>(vpath));
+    }
+};
+
+class ProgressiveProvider final : public IAssetProvider
+{
+public:
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &loc) final
+    {
+        return (bpf::memory::MakeUnique<ProgressiveBuilder>(loc == "none" ? 0 : 3));
+    }
+};
+
+TEST(AssetManager, Progressive)
+{
+    AssetManager manager(1);
+
+    manager.SetProvider<Asset>("progressive", bpf::memory::MakeUnique<ProgressiveProvider>());
+    auto handle = manager.Add("Test/Progressive", "bp3d::Asset/progressive,levels");
+    auto removed = manager.Add("Test/Removed", "bp3d::Asset/progressive,levels");
+    auto single = manager.Add("Test/Single", "bp3d::Asset/progressive,none");
+    while (manager.GetState(handle) != EAssetState::MOUNTED || manager.GetState(removed) != EAssetState::MOUNTED)
+    {
+        manager.Poll();
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    auto *asset = static_cast<ProgressiveAsset *>(manager.Get(handle).Raw());
+    EXPECT_LT(asset->Level, 3); //The coarse version is visible before it is refined
+    manager.Remove("Test/Removed");
+    manager.WaitForAllObjects();
+    EXPECT_EQ(manager.Get(handle).Raw(), asset); //Refined in place
+    EXPECT_EQ(asset->Level, 3);
+    EXPECT_EQ(static_cast<ProgressiveAsset *>(manager.Get(single).Raw())->Level, 0);
+    EXPECT_EQ(manager.GetCPUUsage(), 500u); //Sizes are updated after each refinement
+    EXPECT_EQ(manager.GetState(removed), EAssetState::FAILED);
+}
+
+class StressAsset final : public Asset
+{
+public:
+    bpf::uint32 Magic;
+
+    explicit StressAsset(const bpf::String &vpath)
+        : Asset(bpf::Name(bpf::TypeName<Asset>()), vpath)
+        , Magic(0xB10C)
+    {
+    }
+
+    ~StressAsset()
+    {
+        Magic = 0; //A reader seeing this has accessed a destroyed asset
+    }
+
+    bpf::fsize GetCPUSize() const noexcept final
+    {
+        return (1);
+    }
+};
+
+class StressBuilder final : public SimpleAsset
+{
+public:
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        return (bpf::memory::MakeUnique<StressAsset>(vpath));
+    }
+};
+
+class StressProvider final : public IAssetProvider
+{
+public:
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<StressBuilder>());
+    }
+};
+
+TEST(AssetManager, ConcurrentGet)
+{
+    constexpr bpf::fsize ASSET_COUNT = 64;
+    AssetManager manager(2);
+    bpf::collection::ArrayList<AssetHandle<Asset>> handles;
+    std::atomic<bool> stop(false);
+    std::atomic<bpf::fsize> resolved(0);
+    std::atomic<bpf::fsize> corrupted(0);
+    std::thread readers[4];
+
+    manager.SetProvider<Asset>("stress", bpf::memory::MakeUnique<StressProvider>());
+    for (bpf::fsize i = 0; i != ASSET_COUNT; ++i)
+        handles.Add(manager.Add(bpf::String::Format("Stress/Stable/[]", i), "bp3d::Asset/stress,none"));
+    //Handles of assets removed below, resolved by the readers while they are released and their slots reused
+    for (bpf::fsize i = 0; i != ASSET_COUNT; ++i)
+        handles.Add(manager.Add(bpf::String::Format("Stress/Churn/[]", i), "bp3d::Asset/stress,none"));
+    manager.WaitForAllObjects();
+    for (auto &reader : readers)
+    {
+        reader = std::thread([&]() {
+            while (!stop.load(std::memory_order_relaxed))
+            {
+                auto guard = manager.BeginRead();
+                for (auto &handle : handles)
+                {
+                    auto asset = static_cast<StressAsset *>(manager.Get(guard, handle));
+                    if (asset == nullptr)
+                        continue;
+                    if (asset->Magic != 0xB10C)
+                        corrupted.fetch_add(1, std::memory_order_relaxed);
+                    resolved.fetch_add(1, std::memory_order_relaxed);
+                }
+            }
+        });
+    }
+    for (int round = 0; round != 50; ++round)
+    {
+        //Evict everything then touch the stable assets so that they are reloaded as new instances
+        manager.SetMemoryBudget(1, 0);
+        for (bpf::fsize i = 0; i != ASSET_COUNT; ++i)
+            manager.Get(handles[i]);
+        manager.SetMemoryBudget(0, 0);
+        manager.Remove("Stress/Churn/*");
+        for (bpf::fsize i = 0; i != ASSET_COUNT; ++i)
+            manager.Add(bpf::String::Format("Stress/Churn/[]", i), "bp3d::Asset/stress,none");
+        manager.WaitForAllObjects();
+    }
+    stop = true;
+    for (auto &reader : readers)
+        reader.join();
+    EXPECT_GT(resolved.load(), 0u);
+    EXPECT_EQ(corrupted.load(), 0u);
+    for (bpf::fsize i = 0; i != ASSET_COUNT; ++i)
+        EXPECT_NE(manager.Get(handles[i]), nullptr);
+}
+
+class SweepAsset final : public Asset
+{
+public:
+    int Value;
+
+    explicit SweepAsset(const bpf::String &vpath)
+        : Asset(bpf::Name("SweepAsset"), vpath)
+        , Value(0)
+    {
+    }
+};
+
+BP_DEFINE_TYPENAME(SweepAsset);
+
+class SweepBuilder final : public SimpleAsset
+{
+public:
+    void Build(const CancellationToken &) final
+    {
+    }
+
+    bpf::memory::UniquePtr<Asset> Mount(AssetManager &, const bpf::String &vpath) final
+    {
+        return (bpf::memory::MakeUnique<SweepAsset>(vpath));
+    }
+};
+
+class SweepProvider final : public IAssetProvider
+{
+public:
+    bpf::memory::UniquePtr<IAssetBuilder> Create(const bpf::String &) final
+    {
+        return (bpf::memory::MakeUnique<SweepBuilder>());
+    }
+};
+
+TEST(AssetManager, ForEachType)
+{
+    AssetManager manager;
+    bpf::fsize visited = 0;
+
+    manager.SetProvider<SweepAsset>("sweep", bpf::memory::MakeUnique<SweepProvider>());
+    manager.SetProvider<Asset>("stress", bpf::memory::MakeUnique<StressProvider>());
+    for (int i = 0; i != 10; ++i)
+    {
+        manager.Add(bpf::String::Format("Test/Sweep/[]", i), "SweepAsset/sweep,none");
+        manager.Add(bpf::String::Format("Test/Other/[]", i), "bp3d::Asset/stress,none");
+    }
+    manager.WaitForAllObjects();
+    EXPECT_EQ(manager.GetMountedCount<SweepAsset>(), 10u);
+    EXPECT_EQ(manager.GetMountedCount<Asset>(), 10u);
+    manager.ForEach<SweepAsset>([&](SweepAsset &asset) {
+        asset.Value = 42;
+        ++visited;
+    });
+    EXPECT_EQ(visited, 10u);
+    manager.Remove("Test/Sweep/3");
+    manager.Remove("Test/Sweep/9");
+    manager.Remove("Test/Other/*");
+    visited = 0;
+    manager.ForEach<SweepAsset>([&](SweepAsset &asset) {
+        EXPECT_EQ(asset.Value, 42);
+        EXPECT_NE(asset.VirtualPath(), "Test/Sweep/3");
+        EXPECT_NE(asset.VirtualPath(), "Test/Sweep/9");
+        ++visited;
+    });
+    EXPECT_EQ(visited, 8u);
+    EXPECT_EQ(manager.GetMountedCount<Asset>(), 0u);
+    manager.ForEach<Asset>([](Asset &) { FAIL(); });
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/AssetPathIndex.hpp>
+#include <Framework/Collection/ArrayList.hpp>
+#include <gtest/gtest.h>
+
+using namespace bp3d;
+
+static bpf::uint32 Sum(const AssetPathIndex &index, const bpf::String &prefix)
+{
+    bpf::uint32 sum = 0;
+
+    index.ForEach(prefix, [&](const bpf::uint32 slot) { sum += slot; });
+    return (sum);
+}
+
+TEST(AssetPathIndex, Basic)
+{
+    AssetPathIndex index;
+
+    index.Insert("Level1/Textures/A", 1);
+    index.Insert("Level1/Textures/B", 2);
+    index.Insert("Level1/Model", 4);
+    index.Insert("Level2/Model", 8);
+    index.Insert("Level", 16);
+    EXPECT_EQ(index.Size(), 5u);
+    EXPECT_EQ(Sum(index, ""), 31u);
+    EXPECT_EQ(Sum(index, "Level1/"), 7u);
+    EXPECT_EQ(Sum(index, "Level1/Tex"), 3u);
+    EXPECT_EQ(Sum(index, "Level1/Textures/A"), 1u);
+    EXPECT_EQ(Sum(index, "Level"), 31u);
+    EXPECT_EQ(Sum(index, "Level/"), 0u);
+    EXPECT_EQ(Sum(index, "Level3/"), 0u);
+}
+
+TEST(AssetPathIndex, Remove)
+{
+    AssetPathIndex index;
+
+    index.Insert("Level1/Textures/A", 1);
+    index.Insert("Level1/Textures/B", 2);
+    index.Insert("Level1", 4);
+    EXPECT_FALSE(index.Remove("Level1/Textures"));
+    EXPECT_FALSE(index.Remove("Level2"));
+    EXPECT_TRUE(index.Remove("Level1"));
+    EXPECT_EQ(Sum(index, "Level1"), 3u);
+    EXPECT_TRUE(index.Remove("Level1/Textures/A"));
+    EXPECT_TRUE(index.Remove("Level1/Textures/B"));
+    EXPECT_FALSE(index.Remove("Level1/Textures/B"));
+    EXPECT_EQ(index.Size(), 0u);
+    EXPECT_EQ(Sum(index, ""), 0u);
+}
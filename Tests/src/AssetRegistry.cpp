@@ -0,0 +1,93 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/AssetRegistry.hpp>
+#include <gtest/gtest.h>
+
+using namespace bp3d;
+
+class TrackedAsset final : public Asset
+{
+private:
+    int &_alive;
+
+public:
+    explicit TrackedAsset(int &alive)
+        : Asset(bpf::Name(bpf::TypeName<Asset>()), "Test/Tracked")
+        , _alive(alive)
+    {
+        ++_alive;
+    }
+
+    ~TrackedAsset()
+    {
+        --_alive;
+    }
+};
+
+TEST(AssetRegistry, Resolve)
+{
+    AssetRegistry registry;
+    AssetReadGuard guard(registry);
+    int alive = 0;
+    bpf::memory::UniquePtr<Asset> asset = bpf::memory::MakeUnique<TrackedAsset>(alive);
+
+    EXPECT_EQ(registry.Resolve(guard, AssetHandle<Asset>(3000, 1)), nullptr);
+    registry.Publish(3000, 1, asset.Raw());
+    EXPECT_EQ(registry.Resolve(guard, AssetHandle<Asset>(3000, 1)), asset.Raw());
+    EXPECT_EQ(registry.Resolve(guard, AssetHandle<Asset>(3000, 2)), nullptr);
+    EXPECT_EQ(registry.Resolve(guard, AssetHandle<Asset>(3001, 1)), nullptr);
+    registry.Publish(3000, 2, Null);
+    EXPECT_EQ(registry.Resolve(guard, AssetHandle<Asset>(3000, 1)), nullptr);
+    EXPECT_EQ(registry.Resolve(guard, AssetHandle<Asset>(3000, 2)), nullptr);
+}
+
+TEST(AssetRegistry, Reclaim)
+{
+    AssetRegistry registry;
+    int alive = 0;
+
+    registry.Retire(bpf::memory::MakeUnique<TrackedAsset>(alive));
+    EXPECT_EQ(alive, 0); //No reader: destroyed immediately
+    {
+        AssetReadGuard guard(registry);
+        registry.Retire(bpf::memory::MakeUnique<TrackedAsset>(alive));
+        EXPECT_EQ(alive, 1);
+        for (int i = 0; i != 4; ++i)
+            registry.Reclaim();
+        EXPECT_EQ(alive, 1); //The guard may still use it
+        EXPECT_EQ(registry.GetRetiredCount(), 1u);
+    }
+    {
+        AssetReadGuard guard(registry); //A newer reader does not delay the reclamation
+        registry.Reclaim();
+        registry.Reclaim();
+        EXPECT_EQ(alive, 0);
+        EXPECT_EQ(registry.GetRetiredCount(), 0u);
+    }
+}
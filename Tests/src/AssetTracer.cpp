@@ -0,0 +1,84 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/AssetTracer.hpp>
+#include <Framework/IO/FileStream.hpp>
+#include <Framework/IO/ByteBuf.hpp>
+#include <gtest/gtest.h>
+
+using namespace bp3d;
+
+static bpf::String ReadTrace(const bpf::io::File &file)
+{
+    bpf::io::FileStream stream(file, bpf::io::FILE_MODE_READ);
+    bpf::io::ByteBuf buf(file.GetSizeBytes());
+    bpf::String text;
+
+    stream.Read(*buf, buf.Size());
+    for (bpf::fsize i = 0; i != buf.Size(); ++i)
+        text += static_cast<char>(buf[i]);
+    return (text);
+}
+
+TEST(AssetTracer, Events)
+{
+    bpf::io::File file("./AssetTracer.json");
+    {
+        AssetTracer tracer(file);
+        ASSERT_TRUE(tracer.Start());
+        tracer.Span("Build", "Test/\"A\"", 100, 150);
+        tracer.AsyncSpan("DependencyWait", "Test/B", 150, 170);
+        tracer.Counter("Building", 200, 3);
+        tracer.Flush();
+        auto text = ReadTrace(file);
+        EXPECT_TRUE(text.StartsWith("[\n"));
+        EXPECT_NE(text.IndexOf("\"name\":\"Build\",\"cat\":\"asset\",\"ph\":\"X\""), -1);
+        EXPECT_NE(text.IndexOf("\"ts\":100,\"dur\":50,\"args\":{\"asset\":\"Test/\\\"A\\\"\"}"), -1);
+        EXPECT_NE(text.IndexOf("\"ph\":\"b\""), -1);
+        EXPECT_NE(text.IndexOf("\"ts\":170,\"id\":0"), -1);
+        EXPECT_NE(text.IndexOf("\"name\":\"Building\",\"cat\":\"asset\",\"ph\":\"C\""), -1);
+        EXPECT_NE(text.IndexOf("\"args\":{\"value\":3}"), -1);
+        EXPECT_EQ(tracer.GetDroppedCount(), 0u);
+    }
+    EXPECT_TRUE(ReadTrace(file).EndsWith("{}]\n"));
+    EXPECT_TRUE(file.Delete());
+}
+
+TEST(AssetTracer, Overflow)
+{
+    bpf::io::File file("./AssetTracer_Overflow.json");
+    {
+        AssetTracer tracer(file, 4);
+        ASSERT_TRUE(tracer.Start());
+        for (bpf::uint64 i = 0; i != 10000; ++i)
+            tracer.Counter("Building", i, i);
+        tracer.Flush();
+        EXPECT_TRUE(ReadTrace(file).EndsWith("},\n"));
+    }
+    EXPECT_TRUE(file.Delete());
+}
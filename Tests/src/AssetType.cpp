@@ -0,0 +1,64 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/Asset.hpp>
+#include <gtest/gtest.h>
+
+using namespace bp3d;
+
+class TestTypeAsset final : public Asset
+{
+public:
+    explicit TestTypeAsset(const bpf::String &vpath)
+        : Asset(bpf::Name("TestTypeAsset"), vpath)
+    {
+    }
+};
+
+BP_DEFINE_TYPENAME(TestTypeAsset);
+
+TEST(AssetType, Id)
+{
+    auto base = AssetType::Id<Asset>();
+    auto derived = AssetType::Id<TestTypeAsset>();
+
+    EXPECT_NE(base, derived);
+    EXPECT_EQ(AssetType::Id<Asset>(), base);
+    EXPECT_EQ(AssetType::Register(bpf::Name(bpf::TypeName<Asset>())), base);
+    EXPECT_LT(base, AssetType::GetCount());
+    EXPECT_LT(derived, AssetType::GetCount());
+}
+
+TEST(AssetType, Asset)
+{
+    TestTypeAsset asset("Test/Type");
+    Asset def;
+
+    EXPECT_EQ(asset.TypeId(), AssetType::Id<TestTypeAsset>());
+    EXPECT_EQ(def.TypeId(), AssetType::Id<Asset>());
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/AssetUrl.hpp>
+#include <gtest/gtest.h>
+
+using namespace bp3d;
+
+TEST(AssetUrl, Parse)
+{
+    AssetUrl url("bp3d::Asset/null,%Assets%/test.null");
+
+    EXPECT_TRUE(url.IsValid());
+    EXPECT_STREQ(*url.GetFormat(), "bp3d::Asset/null");
+    EXPECT_STREQ(*url.GetLocation(), "%Assets%/test.null");
+    EXPECT_EQ(url.GetProvider(), bpf::Name("bp3d::Asset/null"));
+    EXPECT_EQ(url.GetRoot(), EAssetRoot::ASSETS);
+    EXPECT_STREQ(*url.ToString(), "bp3d::Asset/null,%Assets%/test.null");
+    EXPECT_EQ(AssetUrl("bp3d::Asset/null,none").GetRoot(), EAssetRoot::NONE);
+}
+
+TEST(AssetUrl, Invalid)
+{
+    EXPECT_FALSE(AssetUrl().IsValid());
+    EXPECT_FALSE(AssetUrl("invalid").IsValid());
+    EXPECT_FALSE(AssetUrl(",none").IsValid());
+    EXPECT_FALSE(AssetUrl("bp3d::Asset/null,").IsValid());
+    EXPECT_FALSE(AssetUrl("bp3d::Asset/null,a,b").IsValid());
+    EXPECT_STREQ(*AssetUrl("invalid").ToString(), "invalid");
+}
+
+TEST(AssetUrl, Resolve)
+{
+    bpf::system::Paths paths(bpf::io::File("/app"), bpf::io::File(), bpf::io::File(), bpf::io::File("/cache"));
+
+    EXPECT_STREQ(*AssetUrl("bp3d::Asset/null,%App%/a.txt").Resolve(paths).Path(), "/app/a.txt");
+    EXPECT_STREQ(*AssetUrl("bp3d::Asset/null,%Cache%/b.txt").Resolve(paths).Path(), "/cache/b.txt");
+    EXPECT_STREQ(*AssetUrl("bp3d::Asset/null,%Assets%/c.txt").Resolve(paths).Path(), "/app/Assets/c.txt");
+    EXPECT_STREQ(*AssetUrl("bp3d::Asset/null,/abs/d.txt").Resolve(paths).Path(), "/abs/d.txt");
+    EXPECT_STREQ(*AssetUrl::Resolve(paths, "%App%/e.txt").Path(), "/app/e.txt");
+    EXPECT_STREQ(*AssetUrl("bp3d::Asset/null,/abs/%App%/f.txt").Resolve(paths).Path(), "/abs//app/f.txt");
+    EXPECT_STREQ(*AssetUrl::Resolve(paths, "foo/%Assets%/x").Path(), "foo//app/Assets/x");
+    EXPECT_STREQ(*AssetUrl::Resolve(paths, "%App%/%Cache%").Path(), "/app//cache");
+}
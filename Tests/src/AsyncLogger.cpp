@@ -0,0 +1,92 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/AsyncLogger.hpp>
+#include <gtest/gtest.h>
+#include "ListLogHandler.hpp"
+
+using namespace bp3d;
+
+TEST(AsyncLogger, Sync)
+{
+    bpf::collection::List<bpf::String> logs;
+    AsyncLogger logger("Test");
+
+    logger.AddHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    logger.Info("Hello []", 42);
+    logger.Error("[] failed", bpf::String("Something"));
+    ASSERT_EQ(logs.Size(), 2u);
+    EXPECT_STREQ(*logs.First(), "[INFO]Test> Hello 42");
+    EXPECT_STREQ(*logs.Last(), "[ERROR]Test> Something failed");
+}
+
+TEST(AsyncLogger, Async)
+{
+    bpf::collection::List<bpf::String> logs;
+    AsyncLogger logger("Test");
+
+    logger.AddHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    logger.EnableAsync(64); //Smaller than the number of messages so that the caller has to wait
+    EXPECT_TRUE(logger.IsAsync());
+    for (int i = 0; i != 1000; ++i)
+        logger.Warning("Message [] of []", i, bpf::String("Test"));
+    logger.Flush();
+    ASSERT_EQ(logs.Size(), 1000u);
+    int i = 0;
+    for (auto &log : logs)
+        EXPECT_EQ(log, bpf::String::Format("[WARNING]Test> Message [] of Test", i++));
+}
+
+TEST(AsyncLogger, LargeArguments)
+{
+    bpf::collection::List<bpf::String> logs;
+    AsyncLogger logger("Test");
+    bpf::String str("a");
+
+    logger.AddHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+    logger.EnableAsync();
+    //Too large to be stored inline, formatted by the caller instead
+    logger.Info("[][][][][][][][][][][][][][][][][][][][][][][][]", str, str, str, str, str, str, str, str, str, str, str, str,
+                str, str, str, str, str, str, str, str, str, str, str, str);
+    logger.Flush();
+    ASSERT_EQ(logs.Size(), 1u);
+    EXPECT_STREQ(*logs.First(), "[INFO]Test> aaaaaaaaaaaaaaaaaaaaaaaa");
+}
+
+TEST(AsyncLogger, Destroy)
+{
+    bpf::collection::List<bpf::String> logs;
+    {
+        AsyncLogger logger("Test");
+        logger.AddHandler(bpf::memory::MakeUnique<ListLogHandler>(logs));
+        logger.EnableAsync();
+        for (int i = 0; i != 100; ++i)
+            logger.Debug("[]", i);
+    } //Queued messages are dispatched before the background thread stops
+    EXPECT_EQ(logs.Size(), 100u);
+}
@@ -0,0 +1,111 @@
+// Copyright (c) 2020, BlockProject
+//
+// All rights reserved.
+//
+// Redistribution and use in source and binary forms, with or without modification,
+// are permitted provided that the following conditions are met:
+//
+//     * Redistributions of source code must retain the above copyright notice,
+//       this list of conditions and the following disclaimer.
+//     * Redistributions in binary form must reproduce the above copyright notice,
+//       this list of conditions and the following disclaimer in the documentation
+//       and/or other materials provided with the distribution.
+//     * Neither the name of BlockProject nor the names of its contributors
+//       may be used to endorse or promote products derived from this software
+//       without specific prior written permission.
+//
+// THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+// "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+// LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR
+// A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+// CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+// EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+// PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+// PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY OF
+// LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+// NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS
+// SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+
+#include <Engine/RingQueue.hpp>
+#include <Framework/Memory/UniquePtr.hpp>
+#include <Framework/System/Thread.hpp>
+#include <gtest/gtest.h>
+
+using namespace bp3d;
+
+TEST(RingQueue, Basic)
+{
+    RingQueue<int> queue(4);
+    int val;
+
+    EXPECT_EQ(queue.GetCapacity(), 4u);
+    EXPECT_FALSE(queue.TryPop(val));
+    for (int i = 0; i != 4; ++i)
+        EXPECT_TRUE(queue.TryPush(i));
+    val = 42;
+    EXPECT_FALSE(queue.TryPush(val)); //Queue is full
+    EXPECT_EQ(val, 42);
+    EXPECT_EQ(queue.GetSizeApprox(), 4u);
+    for (int i = 0; i != 4; ++i)
+    {
+        EXPECT_TRUE(queue.TryPop(val));
+        EXPECT_EQ(val, i);
+    }
+    EXPECT_FALSE(queue.TryPop(val));
+}
+
+TEST(RingQueue, Move)
+{
+    RingQueue<bpf::memory::UniquePtr<int>> queue(2);
+    auto ptr = bpf::memory::MakeUnique<int>(12);
+    bpf::memory::UniquePtr<int> res;
+
+    EXPECT_TRUE(queue.TryPush(ptr));
+    EXPECT_EQ(ptr, nullptr);
+    EXPECT_TRUE(queue.TryPop(res));
+    EXPECT_EQ(*res, 12);
+}
+
+class RingQueueProducer final : public bpf::system::Thread
+{
+private:
+    RingQueue<int> &_queue;
+
+public:
+    explicit RingQueueProducer(RingQueue<int> &queue)
+        : bpf::system::Thread("RingQueueProducer")
+        , _queue(queue)
+    {
+    }
+
+    void Run() final
+    {
+        for (int i = 1; i <= 1000; ++i)
+        {
+            int val = i;
+            while (!_queue.TryPush(val))
+                ;
+        }
+    }
+};
+
+TEST(RingQueue, Concurrent)
+{
+    RingQueue<int> queue(64);
+    RingQueueProducer p1(queue);
+    RingQueueProducer p2(queue);
+    bpf::uint64 sum = 0;
+    int val;
+
+    p1.Start();
+    p2.Start();
+    for (int i = 0; i != 2000; ++i)
+    {
+        while (!queue.TryPop(val))
+            ;
+        sum += val;
+    }
+    p1.Join();
+    p2.Join();
+    EXPECT_EQ(sum, 2u * (1000u * 1001u / 2u));
+}